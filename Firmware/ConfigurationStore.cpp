@@ -101,8 +101,8 @@ void Config_PrintSettings(uint8_t level)
   }
     // Arc Interpolation Settings
     printf_P(PSTR(
-        "%SArc Settings: P:Max length(mm) S:Min length (mm) N:Corrections R:Min segments F:Segments/sec.\n%S  M214 P%.2f S%.2f N%d R%d F%d\n"),
-        echomagic, echomagic, cs.mm_per_arc_segment, cs.min_mm_per_arc_segment, cs.n_arc_correction, cs.min_arc_segments, cs.arc_segments_per_sec);
+        "%SArc Settings: P:Max length(mm) S:Min length (mm) N:Corrections R:Min segments F:Segments/sec. E:Max chord error (mm)\n%S  M214 P%.2f S%.2f N%d R%d F%d E%.3f\n"),
+        echomagic, echomagic, cs.mm_per_arc_segment, cs.min_mm_per_arc_segment, cs.n_arc_correction, cs.min_arc_segments, cs.arc_segments_per_sec, cs.arc_max_chord_error);
 #ifdef THERMAL_MODEL
     thermal_model_report_settings();
 #endif
@@ -117,7 +117,7 @@ static_assert (NUM_AXIS == 4, "ConfigurationStore M500_conf not implemented for
         "Fix axis_steps_per_mm max_feedrate_normal max_acceleration_mm_per_s2_normal max_jerk max_feedrate_silent"
         " max_acceleration_mm_per_s2_silent array size.");
 
-static_assert (sizeof(M500_conf) == 209, "sizeof(M500_conf) has changed, ensure that EEPROM_VERSION has been incremented, "
+static_assert (sizeof(M500_conf) == 213, "sizeof(M500_conf) has changed, ensure that EEPROM_VERSION has been incremented, "
         "or if you added members in the end of struct, ensure that historically uninitialized values will be initialized."
         "If this is caused by change to more then 8bit processor, decide whether make this struct packed to save EEPROM,"
         "leave as it is to keep fast code, or reorder struct members to pack more tightly.");
@@ -170,7 +170,8 @@ static const M500_conf default_conf PROGMEM =
     DEFAULT_MIN_MM_PER_ARC_SEGMENT,
     DEFAULT_N_ARC_CORRECTION,
     DEFAULT_MIN_ARC_SEGMENTS,
-    DEFAULT_ARC_SEGMENTS_PER_SEC
+    DEFAULT_ARC_SEGMENTS_PER_SEC,
+    DEFAULT_ARC_MAX_CHORD_ERROR
 };
 
 
@@ -202,6 +203,7 @@ bool Config_RetrieveSettings()
         eeprom_init_default_byte(&EEPROM_M500_base->n_arc_correction, pgm_read_byte(&default_conf.n_arc_correction));
         eeprom_init_default_word(&EEPROM_M500_base->min_arc_segments, pgm_read_word(&default_conf.min_arc_segments));
         eeprom_init_default_word(&EEPROM_M500_base->arc_segments_per_sec, pgm_read_word(&default_conf.arc_segments_per_sec));
+        eeprom_init_default_float(&EEPROM_M500_base->arc_max_chord_error, pgm_read_float(&default_conf.arc_max_chord_error));
 
         // Initialize the travel_acceleration in eeprom if not already
         eeprom_init_default_float(&EEPROM_M500_base->travel_acceleration, pgm_read_float(&default_conf.travel_acceleration));
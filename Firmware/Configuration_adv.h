@@ -58,7 +58,7 @@
  * bit 0 = Auto-report temperatures
  * bit 1 = Auto-report fans
  * bit 2 = Auto-report position
- * bit 3 = free
+ * bit 3 = Auto-report main loop latency
  * bit 4 = free
  * bit 5 = free
  * bit 6 = free
@@ -296,6 +296,17 @@
   //#define LA_DEBUG_LOGIC     // @wavexx: setup logic channels for isr debugging
 #endif
 
+// Collect timing statistics of the stepper interrupt (reported and reset by D30)
+// Adds a few microseconds to every stepper interrupt, enable for profiling only.
+//#define STEPPER_ISR_STATS
+
+// Collect latency statistics of the main loop stages and of the blocking calls (reported and reset by D31)
+// Costs ~130 bytes of RAM.
+#define LOOP_STATS
+
+// Collect planner queue occupancy and starvation statistics (reported and reset by M980)
+#define PLANNER_STATS
+
 // Arc interpretation settings : Moved to the variant files.
 
 const unsigned int dropsegments=5; //everything with less than this number of steps will be ignored as move and joined with the next movement
@@ -6,6 +6,7 @@
 #include "util.h"
 #include <stdio.h>
 #include <avr/pgmspace.h>
+#include <util/crc16.h>
 
 #define SHOW_TEMP_ADC_VALUES
 #include "temperature.h"
@@ -71,8 +72,38 @@ int parse_hex(const char* hex, uint8_t* data, int count)
 
 enum class dcode_mem_t:uint8_t { sram, eeprom, progmem, xflash };
 
-void print_mem(daddr_t address, daddr_t count, dcode_mem_t type, uint8_t countperline = 16)
+// read a chunk of memory, XFLASH with a single SPI transaction
+static void read_mem(daddr_t address, uint8_t* data, uint8_t count, dcode_mem_t type)
 {
+    switch (type)
+    {
+    case dcode_mem_t::sram:
+        for (uint8_t i = 0; i < count; ++i)
+            data[i] = ((uint8_t*)address)[i];
+        break;
+    case dcode_mem_t::eeprom: eeprom_read_block(data, (uint8_t*)address, count); break;
+    case dcode_mem_t::progmem: memset(data, 0, count); break;
+#if defined(DEBUG_DCODE6) || defined(DEBUG_DCODES) || defined(XFLASH_DUMP)
+    case dcode_mem_t::xflash: xflash_rd_data(address, data, count); break;
+#else
+    case dcode_mem_t::xflash: memset(data, 0, count); break;
+#endif
+    }
+}
+
+// sporadically call manage_heater, but only when interrupts are enabled (meaning
+// print_mem is called by D2). Don't do anything otherwise: we are inside a crash
+// handler where memory & stack needs to be preserved!
+static void print_mem_keepalive(daddr_t count_before, daddr_t count)
+{
+    if((SREG & (1 << SREG_I)) && ((uint16_t)(count_before / 8192) != (uint16_t)(count / 8192)))
+        manage_heater();
+}
+
+void print_mem(daddr_t address, daddr_t count, dcode_mem_t type)
+{
+    const uint8_t countperline = 16;
+    uint8_t data[countperline];
 #if defined(DEBUG_DCODE6) || defined(DEBUG_DCODES) || defined(XFLASH_DUMP)
     if(type == dcode_mem_t::xflash)
         XFLASH_SPI_ENTER();
@@ -81,37 +112,68 @@ void print_mem(daddr_t address, daddr_t count, dcode_mem_t type, uint8_t countpe
 	{
 		print_hex_word(address);
 		putchar(' ');
-		uint8_t count_line = countperline;
-		while (count && count_line)
+		const uint8_t count_line = (count < countperline)? count: countperline;
+		read_mem(address, data, count_line, type);
+		for (uint8_t i = 0; i < count_line; ++i)
 		{
-			uint8_t data = 0;
-			switch (type)
-			{
-			case dcode_mem_t::sram: data = *((uint8_t*)address); break;
-			case dcode_mem_t::eeprom: data = eeprom_read_byte((uint8_t*)address); break;
-			case dcode_mem_t::progmem: break;
-#if defined(DEBUG_DCODE6) || defined(DEBUG_DCODES) || defined(XFLASH_DUMP)
-            case dcode_mem_t::xflash: xflash_rd_data(address, &data, 1); break;
-#else
-            case dcode_mem_t::xflash: break;
-#endif
-			}
-            ++address;
 			putchar(' ');
-			print_hex_byte(data);
-			count_line--;
-			count--;
-
-            // sporadically call manage_heater, but only when interrupts are enabled (meaning
-            // print_mem is called by D2). Don't do anything otherwise: we are inside a crash
-            // handler where memory & stack needs to be preserved!
-            if((SREG & (1 << SREG_I)) && !((uint16_t)count % 8192))
-                manage_heater();
+			print_hex_byte(data[i]);
 		}
 		putchar('\n');
+		address += count_line;
+		count -= count_line;
+		print_mem_keepalive(count + count_line, count);
 	}
 }
 
+#define DCODE_FRAME_SIZE 48 // bytes per framed line, a multiple of 3 to avoid base64 padding
+
+static const char base64_chars[] PROGMEM = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+static void print_base64(const uint8_t* data, uint8_t count)
+{
+    for (uint8_t i = 0; i < count; i += 3)
+    {
+        uint32_t v = (uint32_t)data[i] << 16;
+        if (i + 1 < count) v |= (uint16_t)data[i + 1] << 8;
+        if (i + 2 < count) v |= data[i + 2];
+        putchar(pgm_read_byte(&base64_chars[(v >> 18) & 0x3f]));
+        putchar(pgm_read_byte(&base64_chars[(v >> 12) & 0x3f]));
+        putchar((i + 1 < count)? pgm_read_byte(&base64_chars[(v >> 6) & 0x3f]): '=');
+        putchar((i + 2 < count)? pgm_read_byte(&base64_chars[v & 0x3f]): '=');
+    }
+}
+
+// Compact output, about half the size of print_mem(): each line is
+// "#<address> <base64 data> <crc16>", with the CRC16 CCITT (initial value 0xffff) of the data.
+void print_mem_framed(daddr_t address, daddr_t count, dcode_mem_t type)
+{
+    uint8_t data[DCODE_FRAME_SIZE];
+#if defined(DEBUG_DCODE6) || defined(DEBUG_DCODES) || defined(XFLASH_DUMP)
+    if(type == dcode_mem_t::xflash)
+        XFLASH_SPI_ENTER();
+#endif
+    while (count)
+    {
+        const uint8_t count_line = (count < DCODE_FRAME_SIZE)? count: DCODE_FRAME_SIZE;
+        read_mem(address, data, count_line, type);
+        uint16_t crc = 0xffff;
+        for (uint8_t i = 0; i < count_line; ++i)
+            crc = _crc_ccitt_update(crc, data[i]);
+        putchar('#');
+        print_hex_word(address);
+        putchar(' ');
+        print_base64(data, count_line);
+        putchar(' ');
+        print_hex_byte(crc >> 8);
+        print_hex_byte(crc & 0xff);
+        putchar('\n');
+        address += count_line;
+        count -= count_line;
+        print_mem_keepalive(count + count_line, count);
+    }
+}
+
 // TODO: this only handles SRAM/EEPROM 16bit addresses
 void write_mem(uint16_t address, uint16_t count, const uint8_t* data, const dcode_mem_t type)
 {
@@ -153,7 +215,11 @@ void dcode_core(daddr_t addr_start, const daddr_t addr_end, const dcode_mem_t ty
         DBG(_N("%u bytes written to %S at address 0x%08x\n"), count, type_desc, addr_start);
 #endif
     }
-    print_mem(addr_start, count, type);
+    // not a hex digit, which could match inside the X data
+    if (code_seen('P'))
+        print_mem_framed(addr_start, count, type);
+    else
+        print_mem(addr_start, count, type);
 }
 
 #if defined DEBUG_DCODE3 || defined DEBUG_DCODES
@@ -163,12 +229,13 @@ void dcode_core(daddr_t addr_start, const daddr_t addr_end, const dcode_mem_t ty
     This command can be used without any additional parameters. It will read the entire eeprom.
     #### Usage
 
-        D3 [ A | C | X ]
+        D3 [ A | C | X | P ]
 
     #### Parameters
     - `A` - Address (x0000-x0fff)
     - `C` - Count (1-4096)
     - `X` - Data (hex)
+    - `P` - Packed output: base64 with a CRC16 per line
 
 	#### Notes
 	- The hex address needs to be lowercase without the 0 before the x
@@ -259,12 +326,13 @@ void dcode_1()
     This command can be used without any additional parameters. It will read the entire RAM.
     #### Usage
 
-        D2 [ A | C | X ]
+        D2 [ A | C | X | P ]
 
     #### Parameters
     - `A` - Address (x0000-x21ff)
     - `C` - Count (1-8704)
     - `X` - Data
+    - `P` - Packed output: base64 with a CRC16 per line
 
 	#### Notes
 	- The hex address needs to be lowercase without the 0 before the x
@@ -408,12 +476,13 @@ void dcode_5()
     This command can be used without any additional parameters. It will read the entire XFLASH.
     #### Usage
 
-        D6 [ A | C | X ]
+        D6 [ A | C | X | P ]
 
     #### Parameters
     - `A` - Address (x0000-x3ffff)
     - `C` - Count (1-262144)
     - `X` - Data
+    - `P` - Packed output: base64 with a CRC16 per line
 
 	#### Notes
 	- The hex address needs to be lowercase without the 0 before the x
@@ -933,7 +1002,11 @@ void dcode_21()
     {
         KEEPALIVE_STATE(NOT_BUSY);
         DBG(_N("D21 - read crash dump\n"));
-        print_mem(DUMP_OFFSET, sizeof(dump_t), dcode_mem_t::xflash);
+        const uint16_t size = xfdump_stored_size();
+        if (code_seen('P'))
+            print_mem_framed(DUMP_OFFSET, size, dcode_mem_t::xflash);
+        else
+            print_mem(DUMP_OFFSET, size, dcode_mem_t::xflash);
     }
 }
 
@@ -949,6 +1022,31 @@ void dcode_22()
 }
 #endif
 
+#ifdef STEPPER_ISR_STATS
+#include "stepper.h"
+
+void dcode_30()
+{
+    stepper_isr_stats_t stats;
+    st_isr_stats_get(stats);
+    if (code_seen('R'))
+        st_isr_stats_reset();
+
+    // TIMER1 ticks are 0.5us. The 48 bit sum is divided as a float, which is plenty for an average.
+    uint16_t avg = stats.count? ((stats.sum_hi * 4294967296.f + stats.sum) / stats.count): 0;
+    if (!stats.count) stats.min = 0;
+    DBG(_N("D30 - stepper isr\n"));
+    DBG(_N("count:%lu min:%uus avg:%uus max:%uus\n"), stats.count, stats.min >> 1, avg >> 1, stats.max >> 1);
+    if (stats.count == UINT32_MAX)
+        DBG(_N("saturated, reset with D30 R\n"));
+    DBG(_N("clamped:%lu missed:%lu\n"), stats.clamped, stats.missed);
+    const uint8_t width = (1 << STEPPER_ISR_STATS_BUCKET_SHIFT) >> 1;
+    for (uint8_t i = 0; i < STEPPER_ISR_STATS_BUCKETS; ++i)
+        DBG(_N("%S%uus:%lu\n"), (i == STEPPER_ISR_STATS_BUCKETS - 1)? PSTR(">="): PSTR("<"),
+            (i == STEPPER_ISR_STATS_BUCKETS - 1)? i * width: (i + 1) * width, stats.hist[i]);
+}
+#endif //STEPPER_ISR_STATS
+
 #ifdef EMERGENCY_SERIAL_DUMP
 #include "asm.h"
 #include "xflash_dump.h"
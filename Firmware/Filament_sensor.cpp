@@ -431,7 +431,7 @@ void PAT9125_sensor::setJamDetectionEnabled(bool state, bool updateEEPROM) {
     jamDetection = state;
     oldPos = pat9125_y;
     resetStepCount();
-    jamErrCnt = 0;
+    jam.reset();
     if (updateEEPROM) {
         eeprom_update_byte_notify((uint8_t *)EEPROM_FSENSOR_JAM_DETECTION, state);
     }
@@ -450,7 +450,7 @@ int16_t PAT9125_sensor::getStepCount() {
 }
 
 void PAT9125_sensor::resetStepCount() {
-    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { stepCount = 0; }
+    chunkStart = getStepCount();
 }
 
 void PAT9125_sensor::filJam() {
@@ -466,24 +466,18 @@ void PAT9125_sensor::filJam() {
 
 bool PAT9125_sensor::updatePAT9125() {
     if (jamDetection) {
-        int16_t _stepCount = getStepCount();
+        // The stepper isr only ever adds to stepCount, steps done while evaluating the chunk count into the next one.
+        int16_t _stepCount = getStepCount() - chunkStart;
         if (abs(_stepCount) >= chunkSteps) { // end of chunk. Check distance
-            resetStepCount();
-            if (!pat9125_update()) { // get up to date data. reinit on error.
+            chunkStart += _stepCount;
+            if (!pat9125_update_y()) { // get up to date data, FRAME and SHUTTER are not needed here. reinit on error.
                 init();              // try to reinit.
             }
-            bool fsDir = (pat9125_y - oldPos) > 0;
-            bool stDir = _stepCount > 0;
-            if (fsDir != stDir) {
-                jamErrCnt++;
-            } else if (jamErrCnt) {
-                jamErrCnt--;
-            }
+            const int16_t motion = pat9125_y - oldPos;
             oldPos = pat9125_y;
-        }
-        if (jamErrCnt > 10) {
-            jamErrCnt = 0;
-            filJam();
+            if (jam.chunk(_stepCount, motion)) {
+                filJam();
+            }
         }
     }
 
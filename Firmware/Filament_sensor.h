@@ -6,6 +6,7 @@
 #include "fastio.h"
 #include "adc.h"
 #include "pat9125.h"
+#include "fsensor_jam.h"
 
 #define FSENSOR_IR 1
 #define FSENSOR_IR_ANALOG 2
@@ -172,6 +173,9 @@ public:
     void stStep(bool rev) { //from stepper isr
         stepCount += rev ? -1 : 1;
     }
+    void stSteps(int8_t steps) { //from stepper isr (LIN_ADVANCE, several steps at once)
+        stepCount += steps;
+    }
 
     void settings_init();
 private:
@@ -183,9 +187,10 @@ private:
 
     bool jamDetection;
     int16_t oldPos;
-    int16_t stepCount;
+    int16_t stepCount; ///< free running, only written by the stepper isr
+    int16_t chunkStart; ///< stepCount at the start of the current chunk
     int16_t chunkSteps;
-    uint8_t jamErrCnt;
+    FSensorJamDetector jam;
 
     constexpr void calcChunkSteps(float u) {
         chunkSteps = (int16_t)(1.25 * u); //[mm]
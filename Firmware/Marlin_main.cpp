@@ -52,6 +52,7 @@
 #ifdef MESH_BED_LEVELING
   #include "mesh_bed_leveling.h"
   #include "mesh_bed_calibration.h"
+  #include "mesh_probe_order.h"
 #endif
 
 #include "printers.h"
@@ -84,6 +85,7 @@
 #include "Dcodes.h"
 #include "SpoolJoin.h"
 #include "stopwatch.h"
+#include "loop_stats.h"
 
 #ifndef LA_NOCOMPAT
 #include "la10compat.h"
@@ -315,7 +317,7 @@ class AutoReportFeatures {
             uint8_t temp : 1; //Temperature flag
             uint8_t fans : 1; //Fans flag
             uint8_t pos: 1;   //Position flag
-            uint8_t ar4 : 1;  //Unused
+            uint8_t loop : 1; //Main loop latency flag
             uint8_t ar5 : 1;  //Unused
             uint8_t ar6 : 1;  //Unused
             uint8_t ar7 : 1;  //Unused
@@ -342,6 +344,9 @@ public:
     inline bool Pos()const { return arFunctionsActive.bits.pos != 0; }
     inline void SetPos(uint8_t v){ arFunctionsActive.bits.pos = v; }
 
+    inline bool Loop()const { return arFunctionsActive.bits.loop != 0; }
+    inline void SetLoop(uint8_t v){ arFunctionsActive.bits.loop = v; }
+
     inline void SetMask(uint8_t mask){ arFunctionsActive.byte = mask; }
 
     /// sets the autoreporting timer's period
@@ -684,6 +689,20 @@ void failstats_reset_print()
 	eeprom_update_byte_notify((uint8_t *)EEPROM_MMU_LOAD_FAIL, 0);
 }
 
+/// Reset the runtime diagnostics when a new print is started
+static void diagnostics_reset_print()
+{
+#ifdef STEPPER_ISR_STATS
+    st_isr_stats_reset();
+#endif //STEPPER_ISR_STATS
+#ifdef LOOP_STATS
+    loop_stats_reset();
+#endif //LOOP_STATS
+#ifdef PLANNER_STATS
+    planner_stats_reset();
+#endif //PLANNER_STATS
+}
+
 void watchdogEarlyDisable(void) {
     // Regardless if the watchdog support is enabled or not, disable the watchdog very early
     // after the program starts since there's no danger in doing this.
@@ -699,6 +718,7 @@ void watchdogEarlyDisable(void) {
 }
 
 void softReset(void) {
+    eeprom_cache_flush();
     cli();
 #ifdef WATCHDOG
     // If the watchdog support is enabled, use that for resetting. The timeout value is customized
@@ -1565,6 +1585,10 @@ void setup()
     fw_crash_init();
 
 #ifdef UVLO_SUPPORT
+#ifdef XFLASH
+  if (xflash_success && printer_recovering())
+      uvlo_record_restore();
+#endif //XFLASH
   if (printer_recovering()) { //previous print was terminated by UVLO
       manage_heater(); // Update temperatures
       //Restore printing type
@@ -1595,6 +1619,11 @@ void setup()
       }
   }
 
+#ifdef XFLASH
+  if (xflash_success)
+      uvlo_record_prepare();
+#endif //XFLASH
+
   // Only arm the uvlo interrupt _after_ a recovering print has been initialized and
   // the entire state machine initialized.
   setup_uvlo_interrupt();
@@ -1661,6 +1690,11 @@ void host_autoreport()
             gcode_M123();
         }
 #endif //AUTO_REPORT and (FANCHECK and TACH_0 or TACH_1)
+#ifdef LOOP_STATS
+        if(autoReportFeatures.Loop()){
+            loop_stats_report(false);
+        }
+#endif //LOOP_STATS
         autoReportFeatures.TimerStart();
     }
 }
@@ -1706,6 +1740,10 @@ void host_keepalive() {
 // Before loop(), the setup() function is called by the main() routine.
 void loop()
 {
+#ifdef LOOP_STATS
+    loop_stats_begin();
+#endif //LOOP_STATS
+
     // Reset a previously aborted command, we can now start processing motion again
     planner_aborted = false;
 
@@ -1740,6 +1778,9 @@ void loop()
   #ifdef SDSUPPORT
   card.checkautostart(false);
   #endif
+#ifdef LOOP_STATS
+  loop_stats_mark(LoopStage::get_command);
+#endif //LOOP_STATS
   if(buflen)
   {
     cmdbuffer_front_already_processed = false;
@@ -1812,11 +1853,23 @@ void loop()
 	host_keepalive();
   }
 }
+#ifdef LOOP_STATS
+  loop_stats_mark(LoopStage::process_commands);
+#endif //LOOP_STATS
   //check heater every n milliseconds
   manage_heater();
+#ifdef LOOP_STATS
+  loop_stats_mark(LoopStage::manage_heater);
+#endif //LOOP_STATS
   manage_inactivity(printingIsPaused());
+#ifdef LOOP_STATS
+  loop_stats_mark(LoopStage::manage_inactivity);
+#endif //LOOP_STATS
   checkHitEndstops();
   lcd_update(0);
+#ifdef LOOP_STATS
+  loop_stats_mark(LoopStage::lcd_update);
+#endif //LOOP_STATS
 #ifdef TMC2130
 	tmc2130_check_overtemp();
 	if (tmc2130_sg_crash)
@@ -1833,6 +1886,9 @@ void loop()
 	}
 #endif //TMC2130
 	MMU2::mmu2.mmu_loop();
+#ifdef LOOP_STATS
+  loop_stats_mark(LoopStage::drivers);
+#endif //LOOP_STATS
 }
 
 #define DEFINE_PGM_READ_ANY(type, reader)       \
@@ -2628,6 +2684,14 @@ static void gcode_G80()
     if (uint8_t codeSeen = code_seen('C'), value = code_value_uint8(); codeSeen && value >= 1 && value <= 10)
       nProbeRetryCount = value;
 
+#ifdef MBL_CACHE
+    // 1: reuse the cached mesh, 2: probe the 3x3 points and correct the cached mesh
+    const bool cache_update = code_seen('U');
+    uint8_t cache_mode = cache_update ? code_value_uint8() : 0;
+    if (cache_mode > 2 || (cache_mode && !mbl_cache_valid(nMeasPoints)))
+        cache_mode = 0;
+#endif //MBL_CACHE
+
     const float area_min_x = code_seen('X') ? code_value() - x_mesh_density - X_PROBE_OFFSET_FROM_EXTRUDER : -INFINITY;
     const float area_min_y = code_seen('Y') ? code_value() - y_mesh_density - Y_PROBE_OFFSET_FROM_EXTRUDER : -INFINITY;
     const float area_max_x = code_seen('W') ? area_min_x + code_value() + 2 * x_mesh_density : INFINITY;
@@ -2641,7 +2705,7 @@ static void gcode_G80()
 
     // Initialize the default mesh from eeprom and calculate how many points are to be probed
     bool has_z = is_bed_z_jitter_data_valid(); //checks if we have data from Z calibration (offsets of the Z heiths of the 8 calibration points from the first point)
-    uint8_t meshPointsToProbe = 0;
+    uint8_t row_mask[MESH_NUM_Y_POINTS] = {}; //points to be probed
     for (uint8_t row = 0; row < MESH_NUM_Y_POINTS; row++) {
         for (uint8_t col = 0; col < MESH_NUM_X_POINTS; col++) {
             bool isOn3x3Mesh = ((row % 3 == 0) && (col % 3 == 0));
@@ -2657,6 +2721,12 @@ static void gcode_G80()
             }
 
             // check for points that are skipped
+#ifdef MBL_CACHE
+            if (cache_mode) {
+                if (cache_mode == 1 || !isOn3x3Mesh)
+                    continue;
+            } else
+#endif //MBL_CACHE
             if (nMeasPoints == 3) {
                 if (!isOn3x3Mesh)
                     continue;
@@ -2668,12 +2738,26 @@ static void gcode_G80()
                 }
             }
 
-            // increment the total point counter if the points are not skipped
-            meshPointsToProbe++;
+            row_mask[row] |= 1 << col;
         }
     }
     mbl.upsample_3x3(); //upsample the default mesh
 
+    if (nMeasPoints == 3) {
+        // only the 3x3 points are measured, the rest is interpolated afterwards
+        for (uint8_t row = 0; row < MESH_NUM_Y_POINTS; row++) {
+            for (uint8_t col = 0; col < MESH_NUM_X_POINTS; col++) {
+                if ((row % 3) || (col % 3))
+                    mbl.set_z(col, row, NAN);
+            }
+        }
+    }
+
+    // Visit the points row by row, entering each row from the end closer to the head
+    uint8_t probe_order[MESH_NUM_X_POINTS * MESH_NUM_Y_POINTS];
+    const uint8_t meshPointsToProbe = mesh_probe_order(row_mask, MESH_NUM_X_POINTS, MESH_NUM_Y_POINTS,
+        (current_position[X_AXIS] > BED_X(MESH_NUM_X_POINTS / 2)) ? MESH_NUM_X_POINTS - 1 : 0, probe_order);
+
     // Save custom message state, set a new custom message state to display: Calibrating point 9.
     CustomMsg custom_message_type_old = custom_message_type;
     uint8_t custom_message_state_old = custom_message_state;
@@ -2687,39 +2771,30 @@ static void gcode_G80()
 
     // Cycle through all points and probe them
     int l_feedmultiply = setup_for_endstop_move(false); //save feedrate and feedmultiply, sets feedmultiply to 100
-    uint8_t mesh_point = 0; //index number of calibration point
-    while (mesh_point != MESH_NUM_X_POINTS * MESH_NUM_Y_POINTS) {
+    uint8_t mesh_point = 0; //index into probe_order
+    float z_offset_last = 0; //difference between the measured and the expected height of the last probed point
+    float z_clear = 0; //height clearing the bed next to the last probed point
+    while (mesh_point != meshPointsToProbe) {
         // Get coords of a measuring point.
-        uint8_t ix = mesh_point % MESH_NUM_X_POINTS; // from 0 to MESH_NUM_X_POINTS - 1
-        uint8_t iy = mesh_point / MESH_NUM_X_POINTS;
-        if (iy & 1) ix = (MESH_NUM_X_POINTS - 1) - ix; // Zig zag
-        bool isOn3x3Mesh = ((ix % 3 == 0) && (iy % 3 == 0));
-        float x_pos = BED_X(ix);
-        float y_pos = BED_Y(iy);
-
-        if (nMeasPoints == 3) {
-            if (!isOn3x3Mesh) {
-                mesh_point++;
-                mbl.set_z(ix, iy, NAN);
-                continue; //skip
-            }
-        } else if ((x_pos < area_min_x || x_pos > area_max_x || y_pos < area_min_y || y_pos > area_max_y) && (!isOn3x3Mesh || has_z)) {
-            mesh_point++;
-            continue; //skip
-        }
+        const uint8_t ix = probe_order[mesh_point] % MESH_NUM_X_POINTS; // from 0 to MESH_NUM_X_POINTS - 1
+        const uint8_t iy = probe_order[mesh_point] / MESH_NUM_X_POINTS;
 
-        // Move Z up to the probe height of the current Z point.
+        // Predict the probe start height of the current Z point. The neighbouring points are offset from the
+        // stored mesh by nearly the same amount.
         const float z0 = mbl.z_values[iy][ix];
-        const float init_z_bckp = !has_z ? MESH_HOME_Z_SEARCH : z0 + MESH_HOME_Z_SEARCH_FAST;
-        if (init_z_bckp > current_position[Z_AXIS]) {
-            current_position[Z_AXIS] = init_z_bckp;
+        const float init_z_bckp = has_z ? z0 + z_offset_last + MESH_HOME_Z_SEARCH_FAST : MESH_HOME_Z_SEARCH;
+
+        // Never leave the last point at its trigger height. Without the Z calibration mesh the bed height is
+        // unknown: lift to the search height before travelling. Otherwise lift clear of the last point and
+        // move to XY position of the sensor point and to the start height in a single move.
+        const float lift_z = has_z ? z_clear : init_z_bckp;
+        if (lift_z > current_position[Z_AXIS]) {
+            current_position[Z_AXIS] = lift_z;
             plan_buffer_line_curposXYZE(Z_LIFT_FEEDRATE);
-            st_synchronize();
         }
-
-        // Move to XY position of the sensor point.
-        current_position[X_AXIS] = x_pos;
-        current_position[Y_AXIS] = y_pos;
+        current_position[X_AXIS] = BED_X(ix);
+        current_position[Y_AXIS] = BED_Y(iy);
+        current_position[Z_AXIS] = init_z_bckp;
 
         world2machine_clamp(current_position[X_AXIS], current_position[Y_AXIS]);
 
@@ -2732,8 +2807,8 @@ static void gcode_G80()
             return;
         }
 
-        // Go down until endstop is hit
-        if (!find_bed_induction_sensor_point_z(has_z ? z0 - Z_CALIBRATION_THRESHOLD : -10.f, nProbeRetryCount)) { //if we have data from z calibration max allowed difference is 1mm for each point, if we dont have data max difference is 10mm from initial point
+        // Go down until endstop is hit. With a predicted height the slow approach starts right away.
+        if (!find_bed_induction_sensor_point_z(has_z ? z0 - Z_CALIBRATION_THRESHOLD : -10.f, nProbeRetryCount, has_z ? (BED_PROBE_EARLY_EXIT | BED_PROBE_FROM_CURRENT) : BED_PROBE_EARLY_EXIT)) { //if we have data from z calibration max allowed difference is 1mm for each point, if we dont have data max difference is 10mm from initial point
             printf_P(_T(MSG_BED_LEVELING_FAILED_POINT_LOW));
             break;
         }
@@ -2742,7 +2817,7 @@ static void gcode_G80()
             plan_buffer_line_curposXYZE(Z_LIFT_FEEDRATE);
             st_synchronize();
 
-            if (!find_bed_induction_sensor_point_z(has_z ? z0 - Z_CALIBRATION_THRESHOLD : -10.f, nProbeRetryCount)) { //if we have data from z calibration max allowed difference is 1mm for each point, if we dont have data max difference is 10mm from initial point
+            if (!find_bed_induction_sensor_point_z(has_z ? z0 - Z_CALIBRATION_THRESHOLD : -10.f, nProbeRetryCount, BED_PROBE_EARLY_EXIT)) { //if we have data from z calibration max allowed difference is 1mm for each point, if we dont have data max difference is 10mm from initial point
                 printf_P(_T(MSG_BED_LEVELING_FAILED_POINT_LOW));
                 break;
             }
@@ -2755,6 +2830,8 @@ static void gcode_G80()
             puts_P(PSTR("Bed leveling failed. Too much variation from eeprom mesh"));
             break;
         }
+        z_offset_last = current_position[Z_AXIS] - z0;
+        z_clear = current_position[Z_AXIS] + MESH_HOME_Z_SEARCH_FAST;
 
 #ifdef PINDA_THERMISTOR
         float offset_z = temp_compensation_pinda_thermistor_offset(current_temperature_pinda);
@@ -2771,7 +2848,7 @@ static void gcode_G80()
     plan_buffer_line_curposXYZE(Z_LIFT_FEEDRATE);
     st_synchronize();
     static uint8_t g80_fail_cnt = 0;
-    if (mesh_point != MESH_NUM_X_POINTS * MESH_NUM_Y_POINTS) {
+    if (mesh_point != meshPointsToProbe) {
         if (g80_fail_cnt++ >= 1) {
             print_stop();
             lcd_show_fullscreen_message_and_wait_P(_T(MSG_MBL_FAILED));
@@ -2814,6 +2891,31 @@ static void gcode_G80()
     }
     g80_fail_cnt = 0; // no fail was detected. Reset the error counter.
 
+#ifdef MBL_CACHE
+    if (cache_mode) {
+        // The measured 3x3 points give the shift of the bed since the mesh was cached, interpolate it over the whole mesh
+        for (uint8_t row = 0; row < MESH_NUM_Y_POINTS; row++) {
+            for (uint8_t col = 0; col < MESH_NUM_X_POINTS; col++) {
+                const bool isOn3x3Mesh = ((row % 3 == 0) && (col % 3 == 0));
+                mbl.set_z(col, row, (cache_mode == 2 && isOn3x3Mesh) ? mbl.z_values[row][col] - mbl_cache_z(col, row) : NAN);
+            }
+        }
+        if (cache_mode == 2)
+            mbl.upsample_3x3();
+        for (uint8_t row = 0; row < MESH_NUM_Y_POINTS; row++) {
+            for (uint8_t col = 0; col < MESH_NUM_X_POINTS; col++) {
+                mbl.set_z(col, row, ((cache_mode == 2) ? mbl.z_values[row][col] : 0) + mbl_cache_z(col, row));
+            }
+        }
+        printf_P(PSTR("MBL: cached mesh %S\n"), (cache_mode == 2) ? PSTR("corrected") : PSTR("reused"));
+    } else if (cache_update && (nMeasPoints == 3 || (isinf(area_min_x) && isinf(area_min_y) && isinf(area_max_x) && isinf(area_max_y)))) {
+        // only a mesh covering the whole bed is worth keeping, and only for a G80 which asked for the cache:
+        // the save blocks for about 0.4s and wears the EEPROM
+        mbl.upsample_3x3();
+        mbl_cache_save(nMeasPoints);
+    }
+#endif //MBL_CACHE
+
     clean_up_after_endstop_move(l_feedmultiply);
 
 #ifndef PINDA_THERMISTOR
@@ -2865,6 +2967,9 @@ static void gcode_G80()
     }
 
     mbl.active = 1; //activate mesh bed leveling
+#ifdef UVLO_SUPPORT
+    uvlo_stage_print_settings();
+#endif //UVLO_SUPPORT
 
     if (code_seen('O') && !code_value_uint8()) {
         // Don't let the manage_inactivity() function remove power from the motors.
@@ -3761,6 +3866,7 @@ extern uint8_t st_backlash_y;
 //!@n M917 - Set TMC2130 PWM amplitude offset (pwm_ampl)
 //!@n M918 - Set TMC2130 PWM amplitude gradient (pwm_grad)
 //!@n M928 - Start SD logging (M928 filename.g) - ended by M29
+//!@n M980 - Planner queue statistics
 //! <br><br>
 
 /** @defgroup marlin_main Marlin main */
@@ -4554,9 +4660,15 @@ void process_commands()
 
     #### Parameters
       - `N` - Number of mesh points on x axis. Default is value stored in EEPROM. Valid values are 3 and 7.
-      - `C` - Probe retry counts. Default is value stored in EEPROM. Valid values are 1 to 10.
+      - `C` - Probe retry counts. Default is value stored in EEPROM. Valid values are 1 to 10. Probing of a point stops early once two touches agree, this is the maximum.
       - `O` - Return to origin. Default is 1. Valid values are 0 (false) and 1 (true).
       - `M` - Use magnet compensation. Will only be used if number of mesh points is set to 7. Default is value stored in EEPROM. Valid values are 0 (false) and 1 (true).
+      - `U` - Use the mesh cached by the last G80 U over the whole bed, if it was measured with the same number of points, on the same sheet, at the same bed and PINDA temperature, the printer was not recalibrated since and it is younger than MBL_CACHE_MAX_AGE. G80 without `U` neither uses nor updates the cache.
+        - `U0` - Probe the whole mesh and cache it.
+        - `U1` - Reuse the cached mesh without probing. The whole mesh is probed and cached if the cache cannot be used.
+        - `U2` - Probe the 3x3 points only and shift the cached mesh by the difference. The whole mesh is probed and cached if the cache cannot be used.
+
+        The age of the cache counts the printing time only. A mesh cached before the printer stood idle or switched off for days is still considered fresh, use G80 U0 after the printer was moved or its environment changed.
 
       Using the following parameters enables additional "manual" bed leveling correction. Valid values are -100 microns to 100 microns.
     #### Additional Parameters
@@ -4789,15 +4901,18 @@ void process_commands()
     ### M20 - SD Card file list <a href="https://reprap.org/wiki/G-code#M20:_List_SD_card">M20: List SD card</a>
     #### Usage
 
-        M20 [ L | T ]
+        M20 [ L | T | C ]
     #### Parameters
     - `T` - Report timestamps as well. The value is one uint32_t encoded as hex. Requires host software parsing (Cap:EXTENDED_M20).
     - `L` - Reports long filenames instead of just short filenames. Requires host software parsing (Cap:EXTENDED_M20).
+    - `C` - Compact machine readable listing, one line per file or folder: `<path>,<size>,<timestamp>,<long name>`.
+      Size and timestamp are hex without a prefix, folders end with a `/` and have no size.
+      The long name is empty if there is none and takes the rest of the line. `L` and `T` are implied.
     */
     case 20:
       KEEPALIVE_STATE(NOT_BUSY); // do not send busy messages during listing. Inhibits the output of manage_heater()
       SERIAL_PROTOCOLLNRPGM(_N("Begin file list"));////MSG_BEGIN_FILE_LIST
-      card.ls(CardReader::ls_param(code_seen('L'), code_seen('T')));
+      card.ls(CardReader::ls_param(code_seen('L'), code_seen('T'), code_seen('C')));
       SERIAL_PROTOCOLLNRPGM(_N("End file list"));////MSG_END_FILE_LIST
     break;
 
@@ -4843,6 +4958,10 @@ void process_commands()
       {
               // A new print has started from scratch, reset stats
               failstats_reset_print();
+              diagnostics_reset_print();
+#ifdef UVLO_SUPPORT
+              uvlo_stage_print_settings();
+#endif //UVLO_SUPPORT
               sdpos_atomic = 0;
 #ifndef LA_NOCOMPAT
         la10c_reset();
@@ -4970,6 +5089,10 @@ void process_commands()
             {
                 // A new print has started from scratch, reset stats
                 failstats_reset_print();
+                diagnostics_reset_print();
+#ifdef UVLO_SUPPORT
+                uvlo_stage_print_settings();
+#endif //UVLO_SUPPORT
                 sdpos_atomic = 0;
 #ifndef LA_NOCOMPAT
                 la10c_reset();
@@ -5218,6 +5341,12 @@ void process_commands()
           break;
         }
 
+        if (!print_job_timer.isPaused()) {
+            diagnostics_reset_print();
+#ifdef UVLO_SUPPORT
+            uvlo_stage_print_settings();
+#endif //UVLO_SUPPORT
+        }
         print_job_timer.start();
         break;
     }
@@ -5248,9 +5377,9 @@ void process_commands()
     {
         // @todo useful for maintenance notifications
         SERIAL_ECHOPGM("STATS ");
-        SERIAL_ECHO(eeprom_read_dword((uint32_t *)EEPROM_TOTALTIME));
+        SERIAL_ECHO(eeprom_cache_read_dword((uint32_t *)EEPROM_TOTALTIME));
         SERIAL_ECHOPGM(" min ");
-        SERIAL_ECHO(eeprom_read_dword((uint32_t *)EEPROM_FILAMENTUSED));
+        SERIAL_ECHO(eeprom_cache_read_dword((uint32_t *)EEPROM_FILAMENTUSED));
         SERIAL_ECHOLNPGM(" cm.");
         break;
     }
@@ -5376,7 +5505,7 @@ void process_commands()
           bit 0 = Auto-report temperatures
           bit 1 = Auto-report fans
           bit 2 = Auto-report position
-          bit 3 = free
+          bit 3 = Auto-report main loop latency (D31)
           bit 4 = free
           bit 5 = free
           bit 6 = free
@@ -5485,6 +5614,9 @@ void process_commands()
         cancel_heatup = false;
         target_direction = isHeatingBed(); // true if heating, false if cooling
 
+#ifdef PLANNER_STATS
+        planner_stats_waiting = true;
+#endif //PLANNER_STATS
         while ( (!cancel_heatup) && (target_direction ? (isHeatingBed()) : (isCoolingBed()&&(CooldownNoWait==false))) )
         {
           if (lcd_commands_type == LcdCommands::LongPause) {
@@ -5505,6 +5637,9 @@ void process_commands()
           manage_inactivity();
           lcd_update(0);
         }
+#ifdef PLANNER_STATS
+        planner_stats_waiting = false;
+#endif //PLANNER_STATS
         LCD_MESSAGERPGM(_T(MSG_BED_DONE));
 		heating_status = HeatingStatus::BED_HEATING_COMPLETE;
 
@@ -6084,6 +6219,9 @@ void process_commands()
 		}
 		// steps per sq second need to be updated to agree with the units per sq second (as they are what is used in the planner)
 		reset_acceleration_rates();
+#ifdef UVLO_SUPPORT
+		uvlo_stage_print_settings();
+#endif //UVLO_SUPPORT
 		break;
 
     /*!
@@ -6121,6 +6259,9 @@ void process_commands()
 #endif //TMC2130
 			}
 		}
+#ifdef UVLO_SUPPORT
+		uvlo_stage_print_settings();
+#endif //UVLO_SUPPORT
 		break;
 
     /*!
@@ -6164,6 +6305,9 @@ void process_commands()
           if(code_seen('T'))
             cs.travel_acceleration = code_value();
         }
+#ifdef UVLO_SUPPORT
+        uvlo_stage_print_settings();
+#endif //UVLO_SUPPORT
       }
       break;
 
@@ -6199,6 +6343,9 @@ void process_commands()
 #endif
           cs.max_jerk[E_AXIS] = e;
       }
+#ifdef UVLO_SUPPORT
+      uvlo_stage_print_settings();
+#endif //UVLO_SUPPORT
     }
     break;
 
@@ -6324,10 +6471,11 @@ void process_commands()
 
     #### Usage
 
-        M214 [P] [S] [N] [R] [F]
+        M214 [P] [S] [N] [R] [F] [E]
 
     #### Parameters
     - `P` - A float representing the max and default millimeters per arc segment.  Must be greater than 0.
+            Exceeded on large radii only as far as `E` allows.
     - `S` - A float representing the minimum allowable millimeters per arc segment.  Set to 0 to disable
     - `N` - An int representing the number of arcs to draw before correcting the small angle approximation.  Set to 0 to disable.
     - `R` - An int representing the minimum number of segments per arcs of any radius,
@@ -6335,6 +6483,8 @@ void process_commands()
             and maximum segment length.  Set to 0 to disable.
     - `F` - An int representing the number of segments per second, unless this results in segment lengths
             greater than or less than the minimum and maximum segment length.  Set to 0 to disable.
+    - `E` - A float representing the maximum deviation (mm) of a segment from the true arc. Segments longer than `P`
+            are allowed on large radii while the deviation stays below it.  Set to 0 to make `P` a hard limit.
     */
     case 214:
     {
@@ -6344,9 +6494,10 @@ void process_commands()
         unsigned char n = code_seen('N') ? code_value() : cs.n_arc_correction;
         unsigned short r = code_seen('R') ? code_value() : cs.min_arc_segments;
         unsigned short f = code_seen('F') ? code_value() : cs.arc_segments_per_sec;
+        float e = code_seen('E') ? code_value() : cs.arc_max_chord_error;
 
         // Ensure mm_per_arc_segment is greater than 0, and that min_mm_per_arc_segment is sero or greater than or equal to mm_per_arc_segment
-        if (p <=0 || s < 0 || p < s)
+        if (p <=0 || s < 0 || p < s || e < 0)
         {
             // Should we display some error here?
             break;
@@ -6357,6 +6508,7 @@ void process_commands()
         cs.n_arc_correction = n;
         cs.min_arc_segments = r;
         cs.arc_segments_per_sec = f;
+        cs.arc_max_chord_error = e;
     }break;
 
     /*!
@@ -7469,6 +7621,9 @@ void process_commands()
     */
     case 900:
         gcode_M900();
+#ifdef UVLO_SUPPORT
+        uvlo_stage_print_settings();
+#endif //UVLO_SUPPORT
     break;
 #endif
 
@@ -7758,6 +7913,28 @@ void process_commands()
 #endif //TMC2130_SERVICE_CODES_M910_M918
 #endif // TMC2130
 
+#ifdef PLANNER_STATS
+    /*!
+    ### M980 - Planner queue statistics
+    Print a histogram of the planner queue length observed each time the stepper takes a new block,
+    and how many times the stepper ran out of blocks during an SD or a host print.
+    Waiting for the moves to finish (M400, G4 and any other command calling st_synchronize())
+    or for a heater (M109, M190) empties the queue on purpose and is not counted.
+    The statistics are reset automatically when a new print is started.
+    #### Usage
+
+        M980 [ R ]
+
+    #### Parameters
+    - `R` - Reset the statistics after printing them.
+    */
+    case 980:
+        planner_stats_report();
+        if (code_seen('R'))
+            planner_stats_reset();
+        break;
+#endif //PLANNER_STATS
+
     /*!
     ### M350 - Set microstepping mode <a href="https://reprap.org/wiki/G-code#M350:_Set_microstepping_mode">M350: Set microstepping mode</a>
     Printers with TMC2130 drivers have `X`, `Y`, `Z` and `E` as options. The steps-per-unit value is updated accordingly. Not all resolutions are valid!
@@ -8181,12 +8358,13 @@ void process_commands()
     This command can be used without any additional parameters. It will read the entire RAM.
     #### Usage
 
-        D2 [ A | C | X ]
+        D2 [ A | C | X | P ]
 
     #### Parameters
     - `A` - Address (x0000-x1fff)
     - `C` - Count (1-8192)
     - `X` - Data
+    - `P` - Packed output: base64 with a CRC16 per line
 
     #### Notes
     - The hex address needs to be lowercase without the 0 before the x
@@ -8203,12 +8381,13 @@ void process_commands()
     This command can be used without any additional parameters. It will read the entire eeprom.
     #### Usage
 
-        D3 [ A | C | X ]
+        D3 [ A | C | X | P ]
 
     #### Parameters
     - `A` - Address (x0000-x0fff)
     - `C` - Count (1-4096)
     - `X` - Data (hex)
+    - `P` - Packed output: base64 with a CRC16 per line
 
     #### Notes
     - The hex address needs to be lowercase without the 0 before the x
@@ -8348,7 +8527,10 @@ void process_commands()
     Output the complete crash dump (if present) to the serial.
     #### Usage
 
-     D21
+     D21 [ P ]
+
+    #### Parameters
+    - `P` - Packed output: base64 with a CRC16 per line
 
     ### Notes
     - The starting address can vary between builds, but it's always at the beginning of the data section.
@@ -8389,6 +8571,55 @@ void process_commands()
     };
 #endif
 
+#ifdef STEPPER_ISR_STATS
+    /*!
+    ### D30 - Stepper interrupt timing statistics
+    Print the time spent in the stepper interrupt (minimum, average, maximum and a histogram),
+    how many times the next interrupt had to be postponed to the 8us minimum and how many
+    interrupt deadlines were missed by more than 20us.
+    The statistics are reset automatically when a new print is started. They stop being collected
+    once the interrupt count saturates (about 30 hours at the highest step rate), which is reported.
+    Only available when built with STEPPER_ISR_STATS (Configuration_adv.h).
+    #### Usage
+
+     D30 [R]
+
+    #### Parameters
+    - `R` - Reset the statistics after printing them.
+    */
+    case 30: {
+        dcode_30();
+        break;
+    };
+#endif //STEPPER_ISR_STATS
+
+#ifdef LOOP_STATS
+    /*!
+    ### D31 - Main loop latency statistics
+    Print the maximum duration and the 50/90/99th percentile of each main loop stage
+    (whole loop, get_command, process_commands, manage_heater, manage_inactivity, lcd_update,
+    drivers for the TMC2130 checks and the MMU loop),
+    and the longest blocking call (plan_buffer_line waiting for a free block, st_synchronize,
+    delay_keep_alive) with its timestamp.
+    The percentiles are upper bounds of power-of-two millisecond buckets, 128 means more than 64ms.
+    The statistics are reset automatically when a new print is started.
+    They can be auto-reported with M155 (bit 3).
+    #### Usage
+
+     D31 [H] [R]
+
+    #### Parameters
+    - `H` - Include the per-stage histograms (<1ms, <2ms, <4ms ... <64ms, >=64ms).
+    - `R` - Reset the statistics after printing them.
+    */
+    case 31: {
+        loop_stats_report(code_seen('H'));
+        if (code_seen('R'))
+            loop_stats_reset();
+        break;
+    };
+#endif //LOOP_STATS
+
 #ifdef THERMAL_MODEL_DEBUG
     /*!
     ## D70 - Enable low-level thermal model logging for offline simulation
@@ -8847,6 +9078,11 @@ void manage_inactivity(bool ignore_stepper_queue/*=false*/) //default argument s
 	handleSafetyTimer();
 #endif //SAFETYTIMER
 
+#ifdef UVLO_SUPPORT
+    uvlo_stage_update();
+#endif //UVLO_SUPPORT
+    eeprom_cache_drain();
+
 #if defined(KILL_PIN) && KILL_PIN > -1
 	static int killCount = 0;   // make the inactivity button a bit less responsive
    const int KILL_DELAY = 10000;
@@ -8952,6 +9188,7 @@ void manage_inactivity(bool ignore_stepper_queue/*=false*/) //default argument s
 
 void kill(const char *full_screen_message) {
     cli(); // Stop interrupts
+    eeprom_cache_flush();
     disable_heater();
 
     disable_x();
@@ -9178,12 +9415,13 @@ void setPwmFrequency(uint8_t pin, int val)
 #endif //FAST_PWM_FAN
 
 void save_statistics() {
-    uint32_t _previous_filament = eeprom_init_default_dword((uint32_t *)EEPROM_FILAMENTUSED, 0); //_previous_filament unit: meter
-    uint32_t _previous_time = eeprom_init_default_dword((uint32_t *)EEPROM_TOTALTIME, 0);        //_previous_time unit: min
+    // both are initialized by eeprom_init()
+    uint32_t _previous_filament = eeprom_cache_read_dword((uint32_t *)EEPROM_FILAMENTUSED); //_previous_filament unit: meter
+    uint32_t _previous_time = eeprom_cache_read_dword((uint32_t *)EEPROM_TOTALTIME);        //_previous_time unit: min
 
     uint32_t time_minutes = print_job_timer.duration() / 60;
-    eeprom_update_dword_notify((uint32_t *)EEPROM_TOTALTIME, _previous_time + time_minutes); // EEPROM_TOTALTIME unit: min
-    eeprom_update_dword_notify((uint32_t *)EEPROM_FILAMENTUSED, _previous_filament + (total_filament_used / 1000));
+    eeprom_cache_update_dword((uint32_t *)EEPROM_TOTALTIME, _previous_time + time_minutes); // EEPROM_TOTALTIME unit: min
+    eeprom_cache_update_dword((uint32_t *)EEPROM_FILAMENTUSED, _previous_filament + (total_filament_used / 1000));
 
     print_job_timer.reset();
     total_filament_used = 0;
@@ -9219,6 +9457,11 @@ void calculate_extruder_multipliers() {
 
 void delay_keep_alive(unsigned int ms)
 {
+#ifdef LOOP_STATS
+    // st_synchronize() calls this repeatedly with 0ms and is traced on its own
+    const uint32_t start_us = _micros();
+    const bool traced = ms;
+#endif //LOOP_STATS
     for (;;) {
         manage_heater();
         // Manage inactivity, but don't disable steppers on timeout.
@@ -9234,11 +9477,18 @@ void delay_keep_alive(unsigned int ms)
             ms = 0;
         }
     }
+#ifdef LOOP_STATS
+    if (traced)
+        loop_stats_blocking(BlockingCall::delay_keep_alive, start_us);
+#endif //LOOP_STATS
 }
 
 static void wait_for_heater(long codenum, uint8_t extruder) {
     if (!degTargetHotend(extruder))
         return;
+#ifdef PLANNER_STATS
+    planner_stats_waiting = true;
+#endif //PLANNER_STATS
 
 #ifdef TEMP_RESIDENCY_TIME
 	long residencyStart;
@@ -9293,6 +9543,9 @@ static void wait_for_heater(long codenum, uint8_t extruder) {
 			}
 #endif //TEMP_RESIDENCY_TIME
 	}
+#ifdef PLANNER_STATS
+    planner_stats_waiting = false;
+#endif //PLANNER_STATS
 }
 
 void check_babystep()
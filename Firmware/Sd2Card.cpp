@@ -23,6 +23,7 @@
 #include "Sd2Card.h"
 //------------------------------------------------------------------------------
 #ifndef SOFTWARE_SPI
+#include "spi.h"
 // functions for hardware SPI
 //------------------------------------------------------------------------------
 // make sure SPCR rate is in expected bits
@@ -35,48 +36,31 @@
  */
 static void spiInit(uint8_t spiRate) {
   // See avr processor documentation
-  SPCR = (1 << SPE) | (1 << MSTR) | (spiRate >> 1);
-  SPSR = spiRate & 1 || spiRate == 6 ? 0 : 1 << SPI2X;
+  spi_setup((1 << SPE) | (1 << MSTR) | (spiRate >> 1),
+    spiRate & 1 || spiRate == 6 ? 0 : 1 << SPI2X);
 }
 //------------------------------------------------------------------------------
 /** SPI receive a byte */
 static uint8_t spiRec() {
-  SPDR = 0XFF;
-  while (!(SPSR & (1 << SPIF))) { /* Intentionally left empty */ }
-  return SPDR;
+  return spi_txrx(0XFF);
 }
 //------------------------------------------------------------------------------
 /** SPI read data - only one call so force inline */
 static inline __attribute__((always_inline))
 void spiRead(uint8_t* buf, uint16_t nbyte) {
-  if (nbyte-- == 0) return;
-  SPDR = 0XFF;
-  for (uint16_t i = 0; i < nbyte; i++) {
-    while (!(SPSR & (1 << SPIF))) { /* Intentionally left empty */ }
-    buf[i] = SPDR;
-    SPDR = 0XFF;
-  }
-  while (!(SPSR & (1 << SPIF))) { /* Intentionally left empty */ }
-  buf[nbyte] = SPDR;
+  spi_rx_block(buf, nbyte);
 }
 //------------------------------------------------------------------------------
 /** SPI send a byte */
 static void spiSend(uint8_t b) {
-  SPDR = b;
-  while (!(SPSR & (1 << SPIF))) { /* Intentionally left empty */ }
+  spi_txrx(b);
 }
 //------------------------------------------------------------------------------
 /** SPI send block - only one call so force inline */
 static inline __attribute__((always_inline))
   void spiSendBlock(uint8_t token, const uint8_t* buf) {
-  SPDR = token;
-  for (uint16_t i = 0; i < 512; i += 2) {
-    while (!(SPSR & (1 << SPIF))) { /* Intentionally left empty */ }
-    SPDR = buf[i];
-    while (!(SPSR & (1 << SPIF))) { /* Intentionally left empty */ }
-    SPDR = buf[i + 1];
-  }
-  while (!(SPSR & (1 << SPIF))) { /* Intentionally left empty */ }
+  spiSend(token);
+  spi_tx_block(buf, 512);
 }
 //------------------------------------------------------------------------------
 #else  // SOFTWARE_SPI
@@ -152,6 +136,11 @@ static void spiSend(uint8_t data) {
 //------------------------------------------------------------------------------
 // send command and return error code.  Return zero for OK
 uint8_t Sd2Card::cardCommand(uint8_t cmd, uint32_t arg) {
+  // end an open multiple block sequence, fail the command if the card did not take the stop
+  if (seq_ != SD_SEQ_NONE && cmd != CMD12) {
+    if (!(seq_ == SD_SEQ_READ ? readStop() : writeStop())) return status_ = 0XFF;
+  }
+
   // select card
   chipSelectLow();
 
@@ -285,6 +274,7 @@ bool Sd2Card::eraseSingleBlockEnable() {
  */
 bool Sd2Card::init(uint8_t sckRateID) {
   errorCode_ = type_ = 0;
+  seq_ = SD_SEQ_NONE;
   // 16-bit init start time allows over a minute
   uint16_t t0 = (uint16_t)_millis();
   uint32_t arg;
@@ -475,14 +465,58 @@ static const uint16_t crctab[] PROGMEM = {
   0xEF1F, 0xFF3E, 0xCF5D, 0xDF7C, 0xAF9B, 0xBFBA, 0x8FD9, 0x9FF8,
   0x6E17, 0x7E36, 0x4E55, 0x5E74, 0x2E93, 0x3EB2, 0x0ED1, 0x1EF0
 };
-static uint16_t CRC_CCITT(const uint8_t* data, size_t n) {
+/** CRC CCITT of the data so far and the next byte */
+static inline __attribute__((always_inline))
+uint16_t crcUpdate(uint16_t crc, uint8_t b) {
+  return pgm_read_word(&crctab[(crc >> 8 ^ b) & 0XFF]) ^ (crc << 8);
+}
+//------------------------------------------------------------------------------
+/** SPI read data and return its CRC CCITT - only one call so force inline */
+static inline __attribute__((always_inline))
+uint16_t spiReadCrc(uint8_t* buf, uint16_t nbyte) {
   uint16_t crc = 0;
-  for (size_t i = 0; i < n; i++) {
-    crc = pgm_read_word(&crctab[(crc >> 8 ^ data[i]) & 0XFF]) ^ (crc << 8);
+#ifndef SOFTWARE_SPI
+  // The CRC of a byte is computed while the next one is shifted in. The
+  // loop takes two bytes at a time, as the CRC update nearly fills the byte
+  // time of the fastest SCK rate.
+  if (nbyte == 0) return crc;
+  uint8_t* last = buf + nbyte - 1;
+  uint8_t b;
+  SPDR = 0XFF;
+  if (nbyte & 1) {
+    while (!(SPSR & (1 << SPIF))) { /* Intentionally left empty */ }
+    b = SPDR;
+    if (buf == last) goto done;
+    SPDR = 0XFF;
+    *buf++ = b;
+    crc = crcUpdate(crc, b);
   }
+  for (;;) {
+    while (!(SPSR & (1 << SPIF))) { /* Intentionally left empty */ }
+    b = SPDR;
+    SPDR = 0XFF;
+    *buf++ = b;
+    crc = crcUpdate(crc, b);
+    while (!(SPSR & (1 << SPIF))) { /* Intentionally left empty */ }
+    b = SPDR;
+    if (buf == last) break;
+    SPDR = 0XFF;
+    *buf++ = b;
+    crc = crcUpdate(crc, b);
+  }
+
+ done:
+  *buf = b;
+  crc = crcUpdate(crc, b);
+#else  // SOFTWARE_SPI
+  spiRead(buf, nbyte);
+  for (uint16_t i = 0; i < nbyte; i++) {
+    crc = crcUpdate(crc, buf[i]);
+  }
+#endif  // SOFTWARE_SPI
   return crc;
 }
-#endif
+#endif  // SD_CHECK_AND_RETRY
 
 //------------------------------------------------------------------------------
 bool Sd2Card::readData(uint8_t* dst, uint16_t count) {
@@ -498,12 +532,10 @@ bool Sd2Card::readData(uint8_t* dst, uint16_t count) {
     error(SD_CARD_ERROR_READ);
     goto fail;
   }
-  // transfer data
-  spiRead(dst, count);
-
 #ifdef SD_CHECK_AND_RETRY
   {
-    uint16_t calcCrc = CRC_CCITT(dst, count);
+    // transfer data
+    uint16_t calcCrc = spiReadCrc(dst, count);
     uint16_t recvCrc = spiRec() << 8;
     recvCrc |= spiRec();
     if (calcCrc != recvCrc)
@@ -513,6 +545,9 @@ bool Sd2Card::readData(uint8_t* dst, uint16_t count) {
     }
   }
 #else
+  // transfer data
+  spiRead(dst, count);
+
   // discard CRC
   spiRec();
   spiRec();
@@ -550,7 +585,10 @@ bool Sd2Card::readRegister(uint8_t cmd, void* buf) {
  * \param[in] blockNumber Address of first block in sequence.
  *
  * \note This function is used with readData() and readStop() for optimized
- * multiple block reads.  SPI chipSelect must be low for the entire sequence.
+ * multiple block reads. chipSelect is high between the blocks: the card keeps
+ * the sequence open and ignores the SPI traffic to XFLASH and the TMC2130
+ * drivers while it is deselected. Any other command ends the sequence first,
+ * see cardCommand().
  *
  * \return The value one, true, is returned for success and
  * the value zero, false, is returned for failure.
@@ -561,6 +599,7 @@ bool Sd2Card::readStart(uint32_t blockNumber) {
     error(SD_CARD_ERROR_CMD18);
     goto fail;
   }
+  seq_ = SD_SEQ_READ;
   chipSelectHigh();
   return true;
 
@@ -575,6 +614,7 @@ bool Sd2Card::readStart(uint32_t blockNumber) {
  * the value zero, false, is returned for failure.
  */
 bool Sd2Card::readStop() {
+  seq_ = SD_SEQ_NONE;
   chipSelectLow();
   if (cardCommand(CMD12, 0)) {
     error(SD_CARD_ERROR_CMD12);
@@ -666,6 +706,7 @@ bool Sd2Card::writeData(const uint8_t* src) {
   // wait for previous write to finish
   if (!waitNotBusy(SD_WRITE_TIMEOUT)) goto fail;
   if (!writeData(WRITE_MULTIPLE_TOKEN, src)) goto fail;
+  seqCount_++;
   chipSelectHigh();
   return true;
 
@@ -717,6 +758,8 @@ bool Sd2Card::writeStart(uint32_t blockNumber, uint32_t eraseCount) {
     error(SD_CARD_ERROR_CMD25);
     goto fail;
   }
+  seq_ = SD_SEQ_WRITE;
+  seqCount_ = 0;
   chipSelectHigh();
   return true;
 
@@ -727,19 +770,41 @@ bool Sd2Card::writeStart(uint32_t blockNumber, uint32_t eraseCount) {
 //------------------------------------------------------------------------------
 /** End a write multiple blocks sequence.
  *
+ * The blocks accepted by the card are programmed in the background, so the
+ * status is checked like after a single block write and the card must report
+ * all blocks of the sequence as written.
+ *
 * \return The value one, true, is returned for success and
  * the value zero, false, is returned for failure.
  */
 bool Sd2Card::writeStop() {
+  uint8_t written[4];
+  seq_ = SD_SEQ_NONE;
   chipSelectLow();
-  if (!waitNotBusy(SD_WRITE_TIMEOUT)) goto fail;
+  if (!waitNotBusy(SD_WRITE_TIMEOUT)) goto fail_stop;
   spiSend(STOP_TRAN_TOKEN);
-  if (!waitNotBusy(SD_WRITE_TIMEOUT)) goto fail;
-  chipSelectHigh();
+  if (!waitNotBusy(SD_WRITE_TIMEOUT)) goto fail_stop;
+  // response is r2 so get and check two bytes for nonzero
+  if (cardCommand(CMD13, 0) || spiRec()) {
+    error(SD_CARD_ERROR_WRITE_PROGRAMMING);
+    goto fail;
+  }
+  // number of well written blocks, big endian in a four byte data block
+  if (cardAcmd(ACMD22, 0)) {
+    error(SD_CARD_ERROR_ACMD22);
+    goto fail;
+  }
+  if (!readData(written, 4)) return false;
+  if ((((uint32_t)written[0] << 24) | ((uint32_t)written[1] << 16)
+    | ((uint16_t)written[2] << 8) | written[3]) != seqCount_) {
+    error(SD_CARD_ERROR_WRITE_PROGRAMMING);
+    return false;
+  }
   return true;
 
- fail:
+ fail_stop:
   error(SD_CARD_ERROR_STOP_TRAN);
+ fail:
   chipSelectHigh();
   return false;
 }
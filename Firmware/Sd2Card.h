@@ -106,6 +106,8 @@ uint8_t const SD_CARD_ERROR_INIT_NOT_CALLED = 0X19;
 uint8_t const SD_CARD_ERROR_CRC = 0X20;
 /** no response to sent 0xFF */
 uint8_t const SD_CARD_ERROR_FF_TIMEOUT = 0X21;
+/** ACMD22 failed after a multiple block write */
+uint8_t const SD_CARD_ERROR_ACMD22 = 0X22;
 
 /** Toshiba FlashAir: iSDIO */
 uint8_t const SD_CARD_ERROR_CMD48 = 0x80;
@@ -120,6 +122,14 @@ uint8_t const SD_CARD_TYPE_SD1  = 1;
 uint8_t const SD_CARD_TYPE_SD2  = 2;
 /** High Capacity SD card */
 uint8_t const SD_CARD_TYPE_SDHC = 3;
+//------------------------------------------------------------------------------
+// multiple block sequences, see Sd2Card::sequence()
+/** No multiple block sequence is open */
+uint8_t const SD_SEQ_NONE = 0;
+/** Multiple block read (CMD18) is open */
+uint8_t const SD_SEQ_READ = 1;
+/** Multiple block write (CMD25) is open */
+uint8_t const SD_SEQ_WRITE = 2;
 /**
  * define SOFTWARE_SPI to use bit-bang SPI
  */
@@ -148,7 +158,7 @@ uint8_t const SPI_SCK_PIN = SOFT_SPI_SCK_PIN;
 class Sd2Card {
  public:
   /** Construct an instance of Sd2Card. */
-  Sd2Card() : errorCode_(SD_CARD_ERROR_INIT_NOT_CALLED), type_(0), flash_air_compatible_(false) {}
+  Sd2Card() : errorCode_(SD_CARD_ERROR_INIT_NOT_CALLED), type_(0), flash_air_compatible_(false), seq_(SD_SEQ_NONE), seqCount_(0) {}
   uint32_t cardSize();
   bool erase(uint32_t firstBlock, uint32_t lastBlock);
   bool eraseSingleBlockEnable();
@@ -197,6 +207,10 @@ class Sd2Card {
   bool readData(uint8_t *dst);
   bool readStart(uint32_t blockNumber);
   bool readStop();
+  /** \return The open multiple block sequence, SD_SEQ_NONE, SD_SEQ_READ or
+   * SD_SEQ_WRITE. Any other command ends the sequence first.
+   */
+  uint8_t sequence() const {return seq_;}
   bool setSckRate(uint8_t sckRateID);
   /** Return the card type: SD V1, SD V2 or SDHC
    * \return 0 - SD V1, 1 - SD V2, or 3 - SDHC.
@@ -220,6 +234,8 @@ class Sd2Card {
   uint8_t status_;
   uint8_t type_;
   bool    flash_air_compatible_;
+  uint8_t seq_;
+  uint32_t seqCount_;          // blocks written in the open CMD25 sequence
   // private functions
   uint8_t cardAcmd(uint8_t cmd, uint32_t arg) {
     cardCommand(CMD55, 0);
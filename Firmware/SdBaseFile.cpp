@@ -1104,6 +1104,12 @@ int16_t SdBaseFile::read(void* buf, uint16_t nbyte) {
 /** Read the next directory entry from a directory file.
  *
  * \param[out] dir The dir_t struct that will receive the data.
+ * \param[out] longFilename Receives the long name of the entry, may be NULL.
+ * \param[in] lfnLazy Decode only the first character of the long name, which
+ * is enough to filter hidden files. Seek back and read the entry again to get
+ * the whole name.
+ *
+ * The entries are looked at in the block cache, only the returned one is copied.
  *
  * \return For success readDir() returns the number of bytes read.
  * A value of zero will be returned if end of file is reached.
@@ -1111,8 +1117,7 @@ int16_t SdBaseFile::read(void* buf, uint16_t nbyte) {
  * readDir() called before a directory has been opened, this is not
  * a directory file or an I/O error occurred.
  */
-int8_t SdBaseFile::readDir(dir_t* dir, char* longFilename) {
-  int16_t n;
+int8_t SdBaseFile::readDir(dir_t* dir, char* longFilename, bool lfnLazy) {
   // if not a directory file or miss-positioned return an error
   if (!isDir() || (0X1F & curPosition_)) return -1;
 
@@ -1123,22 +1128,33 @@ int8_t SdBaseFile::readDir(dir_t* dir, char* longFilename) {
   }
 
   while (1) {
-    n = read(dir, sizeof(dir_t));
-    if (n != sizeof(dir_t)) return n == 0 ? 0 : -1;
+    if (curPosition_ >= fileSize_) return 0;
+    const dir_t* p = readDirCache();
+    if (!p) return -1;
     // last entry if DIR_NAME_FREE
-    if (dir->name[0] == DIR_NAME_FREE) return 0;
+    if (p->name[0] == DIR_NAME_FREE) return 0;
     // skip empty entries and entry for .  and ..
-    if (dir->name[0] == DIR_NAME_DELETED || dir->name[0] == '.') continue;
+    if (p->name[0] == DIR_NAME_DELETED || p->name[0] == '.') continue;
     //Fill the long filename if we have a long filename entry,
 	// long filename entries are stored before the actual filename.
-	if (DIR_IS_LONG_NAME(dir) && longFilename != NULL)
+	if (DIR_IS_LONG_NAME(p) && longFilename != NULL)
     {
-    	vfat_t *VFAT = (vfat_t*)dir;
+    	const vfat_t *VFAT = (const vfat_t*)p;
+    	const uint8_t seq = VFAT->sequenceNumber & 0x1F;
 		//Sanity check the VFAT entry. The first cluster is always set to zero. And th esequence number should be higher then 0
-    	if (VFAT->firstClusterLow == 0 && (VFAT->sequenceNumber & 0x1F) > 0 && (VFAT->sequenceNumber & 0x1F) <= MAX_VFAT_ENTRIES)
+    	if (VFAT->firstClusterLow == 0 && seq > 0 && seq <= MAX_VFAT_ENTRIES)
     	{
 			//TODO: Store the filename checksum to verify if a none-long filename aware system modified the file table.
-    		n = ((VFAT->sequenceNumber & 0x1F) - 1) * 13;
+    		if (lfnLazy)
+    		{
+    			if (seq == 1)
+    			{
+    				longFilename[0] = VFAT->name1[0];
+    				longFilename[1] = '\0';
+    			}
+    			continue;
+    		}
+    		uint8_t n = (seq - 1) * 13;
 			longFilename[n+0] = VFAT->name1[0];
 			longFilename[n+1] = VFAT->name1[1];
 			longFilename[n+2] = VFAT->name1[2];
@@ -1158,7 +1174,10 @@ int8_t SdBaseFile::readDir(dir_t* dir, char* longFilename) {
 		}
     }
     // return if normal file or subdirectory
-    if (DIR_IS_FILE_OR_SUBDIR(dir)) return n;
+    if (DIR_IS_FILE_OR_SUBDIR(p)) {
+      memcpy(dir, p, sizeof(dir_t));
+      return sizeof(dir_t);
+    }
   }
 }
 //------------------------------------------------------------------------------
@@ -285,7 +285,7 @@ protected:
   int16_t read();
   int16_t read(void* buf, uint16_t nbyte);
 public:
-  int8_t readDir(dir_t* dir, char* longFilename);
+  int8_t readDir(dir_t* dir, char* longFilename, bool lfnLazy = false);
   static bool remove(SdBaseFile* dirFile, const char* path);
   bool remove();
   /** Set the file's current position to zero. */
@@ -0,0 +1,28 @@
+/// @file
+#include "SdDirIndex.h"
+
+void SdDirIndex::add(uint16_t nr, uint16_t dir_entry) {
+    files = nr + 1;
+    if (nr & ((1 << shift) - 1))
+        return;
+    uint16_t i = nr >> shift;
+    if (i >= SD_DIR_INDEX_SIZE) {
+        // Out of checkpoints, drop every other one and double the stride
+        for (uint8_t j = 1; j < SD_DIR_INDEX_SIZE / 2; ++j)
+            entry[j] = entry[2 * j];
+        ++shift;
+        i >>= 1;
+    }
+    entry[i] = dir_entry;
+}
+
+int32_t SdDirIndex::seek(uint16_t nr, uint16_t &dir_entry) const {
+    if (!files)
+        return -1;
+    uint16_t i = nr >> shift;
+    const uint16_t last = (files - 1) >> shift;
+    if (i > last)
+        i = last;
+    dir_entry = entry[i];
+    return nr - ((uint16_t)i << shift);
+}
@@ -0,0 +1,32 @@
+/// @file
+/// Sparse index of the visible files in the SD working directory.
+#pragma once
+#include <stdint.h>
+
+#define SD_DIR_INDEX_SIZE 32 // checkpoints, 2 bytes of RAM each
+
+/// Remembers the directory entry of every 2^shift-th visible file, so that the n-th file can be
+/// reached by seeking close to it instead of walking the directory from the start.
+/// The stride doubles whenever the directory has more files than checkpoints, which keeps
+/// the RAM usage fixed and the walk after the seek below 2 * files / SD_DIR_INDEX_SIZE.
+class SdDirIndex {
+public:
+    void reset() { files = 0; shift = 0; }
+
+    /// Record a visible file. Called for every file in ascending order while counting the directory.
+    /// @param nr index of the file among the visible files
+    /// @param dir_entry index of its first directory entry (LFN entries included)
+    void add(uint16_t nr, uint16_t dir_entry);
+
+    /// Find the closest checkpoint at or before the nr-th visible file.
+    /// @param dir_entry receives the directory entry to seek to
+    /// @return number of visible files to skip after the seek, or -1 if the directory was not indexed
+    int32_t seek(uint16_t nr, uint16_t &dir_entry) const;
+
+    uint16_t count() const { return files; }
+
+private:
+    uint16_t entry[SD_DIR_INDEX_SIZE];
+    uint16_t files = 0; ///< number of visible files recorded
+    uint8_t shift = 0; ///< log2 of the stride between checkpoints
+};
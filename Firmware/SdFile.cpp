@@ -65,6 +65,7 @@ void __attribute__((noinline)) SdFile::gfUpdateCurrentPosition(uint16_t inc){
     curPosition_ += inc;
 }
 
+#ifndef _NO_ASM
 #define find_endl(resultP, startP) \
 __asm__ __volatile__ (  \
 "cycle:          \n" \
@@ -75,6 +76,10 @@ __asm__ __volatile__ (  \
 : "z" (startP)   /* input of the ASM code - in our case the Z register as well (R30:R31) */ \
 : "r22"          /* modifying register R22 - so that the compiler knows */ \
 )
+#else //_NO_ASM
+#define find_endl(resultP, startP) \
+do { resultP = startP; while (*resultP++ != '\n'); } while (0)
+#endif //_NO_ASM
 
 // avoid calling the default heavy-weight read() for just one byte
 int16_t SdFile::readFilteredGcode(){
@@ -72,6 +72,9 @@ uint8_t const CMD49 = 0x31;
 uint8_t const CMD55 = 0X37;
 /** READ_OCR - read the OCR register of a card */
 uint8_t const CMD58 = 0X3A;
+/** SEND_NUM_WR_BLOCKS - read the number of well written blocks of the last
+    multiple block write */
+uint8_t const ACMD22 = 0X16;
 /** SET_WR_BLK_ERASE_COUNT - Set the number of write blocks to be
      pre-erased before writing */
 uint8_t const ACMD23 = 0X17;
@@ -29,6 +29,8 @@ cache_t  SdVolume::cacheBuffer_;       // 512 byte cache for Sd2Card
 Sd2Card* SdVolume::sdCard_;            // pointer to SD card object
 bool     SdVolume::cacheDirty_;        // cacheFlush() will write block if true
 uint32_t SdVolume::cacheMirrorBlock_;  // mirror  block for second FAT
+uint32_t SdVolume::seqBlock_;          // block following the last transferred one
+uint8_t  SdVolume::seqLast_;           // direction of the last transfer
 #endif  // USE_MULTIPLE_CARDS
 //------------------------------------------------------------------------------
 // find a contiguous group of clusters
@@ -106,12 +108,12 @@ bool SdVolume::allocContiguous(uint32_t count, uint32_t* curCluster) {
 //------------------------------------------------------------------------------
 bool SdVolume::cacheFlush() {
   if (cacheDirty_) {
-    if (!sdCard_->writeBlock(cacheBlockNumber_, cacheBuffer_.data)) {
+    if (!writeBlock(cacheBlockNumber_, cacheBuffer_.data)) {
       goto fail;
     }
     // mirror FAT tables
     if (cacheMirrorBlock_) {
-      if (!sdCard_->writeBlock(cacheMirrorBlock_, cacheBuffer_.data)) {
+      if (!writeBlock(cacheMirrorBlock_, cacheBuffer_.data)) {
         goto fail;
       }
       cacheMirrorBlock_ = 0;
@@ -127,7 +129,7 @@ bool SdVolume::cacheFlush() {
 bool SdVolume::cacheRawBlock(uint32_t blockNumber, bool dirty) {
   if (cacheBlockNumber_ != blockNumber) {
     if (!cacheFlush()) goto fail;
-    if (!sdCard_->readBlock(blockNumber, cacheBuffer_.data)) goto fail;
+    if (!readBlock(blockNumber, cacheBuffer_.data)) goto fail;
     cacheBlockNumber_ = blockNumber;
   }
   if (dirty) cacheDirty_ = true;
@@ -137,6 +139,41 @@ bool SdVolume::cacheRawBlock(uint32_t blockNumber, bool dirty) {
   return false;
 }
 //------------------------------------------------------------------------------
+// Blocks following each other are transferred as a multiple block read (CMD18)
+// or write (CMD25). The second block in a row opens the sequence, which stays
+// open on the card until a block out of the sequence or any other command.
+bool SdVolume::readBlock(uint32_t block, uint8_t* dst) {
+  if (block == seqBlock_ && seqLast_ == SD_SEQ_READ && !sdCard_->getFlashAirCompatible()) {
+    if (sdCard_->sequence() == SD_SEQ_READ || sdCard_->readStart(block)) {
+      if (sdCard_->readData(dst)) goto done;
+      // retry as a single block
+      sdCard_->readStop();
+    }
+  }
+  if (!sdCard_->readBlock(block, dst)) return false;
+
+ done:
+  seqBlock_ = block + 1;
+  seqLast_ = SD_SEQ_READ;
+  return true;
+}
+//------------------------------------------------------------------------------
+bool SdVolume::writeBlock(uint32_t block, const uint8_t* src) {
+  if (block == seqBlock_ && seqLast_ == SD_SEQ_WRITE && !sdCard_->getFlashAirCompatible()) {
+    // pre-erase just the block being written, the length of the sequence is unknown
+    if (sdCard_->sequence() == SD_SEQ_WRITE || sdCard_->writeStart(block, 1)) {
+      if (sdCard_->writeData(src)) goto done;
+      sdCard_->writeStop();
+    }
+  }
+  if (!sdCard_->writeBlock(block, src)) return false;
+
+ done:
+  seqBlock_ = block + 1;
+  seqLast_ = SD_SEQ_WRITE;
+  return true;
+}
+//------------------------------------------------------------------------------
 // return the size in bytes of a cluster chain
 bool SdVolume::chainSize(uint32_t cluster, uint32_t* size) {
   uint32_t s = 0;
@@ -332,6 +369,8 @@ bool SdVolume::init(Sd2Card* dev, uint8_t part) {
   cacheDirty_ = 0;  // cacheFlush() will write block if true
   cacheMirrorBlock_ = 0;
   cacheBlockNumber_ = 0XFFFFFFFF;
+  seqBlock_ = 0XFFFFFFFF;
+  seqLast_ = SD_SEQ_NONE;
 
   // if part == 0 assume super floppy with FAT boot sector in block zero
   // if part > 0 assume mbr volume with partition table
@@ -134,12 +134,16 @@ class SdVolume {
   Sd2Card* sdCard_;            // Sd2Card object for cache
   bool cacheDirty_;            // cacheFlush() will write block if true
   uint32_t cacheMirrorBlock_;  // block number for mirror FAT
+  uint32_t seqBlock_;          // block following the last transferred one
+  uint8_t seqLast_;            // direction of the last transfer, SD_SEQ_READ or SD_SEQ_WRITE
 #else  // USE_MULTIPLE_CARDS
   static cache_t cacheBuffer_;        // 512 byte cache for device blocks
   static uint32_t cacheBlockNumber_;  // Logical number of block in the cache
   static Sd2Card* sdCard_;            // Sd2Card object for cache
   static bool cacheDirty_;            // cacheFlush() will write block if true
   static uint32_t cacheMirrorBlock_;  // block number for mirror FAT
+  static uint32_t seqBlock_;          // block following the last transferred one
+  static uint8_t seqLast_;            // direction of the last transfer, SD_SEQ_READ or SD_SEQ_WRITE
 #endif  // USE_MULTIPLE_CARDS
   uint32_t allocSearchStart_;   // start cluster for alloc search
   uint8_t blocksPerCluster_;    // cluster size in blocks
@@ -165,9 +169,13 @@ class SdVolume {
 #if USE_MULTIPLE_CARDS
   bool cacheFlush();
   bool cacheRawBlock(uint32_t blockNumber, bool dirty);
+  bool readBlock(uint32_t block, uint8_t* dst);
+  bool writeBlock(uint32_t block, const uint8_t* src);
 #else  // USE_MULTIPLE_CARDS
   static bool cacheFlush();
   static bool cacheRawBlock(uint32_t blockNumber, bool dirty);
+  static bool readBlock(uint32_t block, uint8_t* dst);
+  static bool writeBlock(uint32_t block, const uint8_t* src);
 #endif  // USE_MULTIPLE_CARDS
   // used by SdBaseFile write to assign cache to SD location
   void cacheSetBlockNumber(uint32_t blockNumber, bool dirty) {
@@ -187,11 +195,6 @@ class SdVolume {
     if (fatType_ == 16) return cluster >= FAT16EOC_MIN;
     return  cluster >= FAT32EOC_MIN;
   }
-  bool readBlock(uint32_t block, uint8_t* dst) {
-    return sdCard_->readBlock(block, dst);}
-  bool writeBlock(uint32_t block, const uint8_t* dst) {
-    return sdCard_->writeBlock(block, dst);
-  }
 //------------------------------------------------------------------------------
   // Deprecated functions  - suppress cpplint warnings with NOLINT comment
 #if ALLOW_DEPRECATED_FUNCTIONS && !defined(DOXYGEN)
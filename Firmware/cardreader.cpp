@@ -58,6 +58,16 @@ char *createFilename(char *buffer,const dir_t &p) //buffer>12characters
   return buffer;
 }
 
+// Most recent one of the creation and modification timestamps
+static uint32_t lsTimestamp(const dir_t &p) {
+	uint16_t date = p.lastWriteDate, time = p.lastWriteTime;
+	if (date < p.creationDate || (date == p.creationDate && time < p.creationTime)) {
+		date = p.creationDate;
+		time = p.creationTime;
+	}
+	return ((uint32_t)date << 16) | time;
+}
+
 /**
 +* Dive into a folder and recurse depth-first to perform a pre-set operation lsAction:
 +*   LS_Count           - Add +1 to nrFiles for every file within the parent
@@ -65,7 +75,7 @@ char *createFilename(char *buffer,const dir_t &p) //buffer>12characters
 +*   LS_SerialPrint     - Print the full path and size of each file to serial output
 +*/
 
-void CardReader::lsDive(const char *prepend, SdFile parent, const char * const match/*=NULL*/, LsAction lsAction, ls_param lsParams) {
+void CardReader::lsDive(const char *prepend, SdFile &parent, const char * const match/*=NULL*/, LsAction lsAction, ls_param lsParams) {
 	static uint8_t recursionCnt = 0;
 	// RAII incrementer for the recursionCnt
 	class _incrementer
@@ -77,8 +87,10 @@ void CardReader::lsDive(const char *prepend, SdFile parent, const char * const m
 
 	dir_t p;
 	uint8_t cnt = 0;
+	// Long names are only decoded for the printed and the returned entries
+	const bool lfnLazy = (lsAction != LS_SerialPrint) || !(lsParams.LFN || lsParams.compact);
 		// Read the next entry from a directory
-		for (position = parent.curPosition(); parent.readDir(p, longFilename) > 0; position = parent.curPosition()) {
+		for (position = parent.curPosition(); parent.readDir(&p, longFilename, lfnLazy) > 0; position = parent.curPosition()) {
 			if (recursionCnt > MAX_DIR_DEPTH)
 				return;
 			uint8_t pn0 = p.name[0];
@@ -104,11 +116,14 @@ void CardReader::lsDive(const char *prepend, SdFile parent, const char * const m
 				// Get a new directory object using the full path
 				// and dive recursively into it.
 
-				if (lsParams.LFN)
+				if (lsParams.compact)
+					printf_P(PSTR("%s,,%lx,%s\n"), path, lsTimestamp(p), longFilename);
+				else if (lsParams.LFN)
 					printf_P(PSTR("DIR_ENTER: %s \"%s\"\n"), path, longFilename[0] ? longFilename : lfilename);
 
+				// Open the entry which was just read, instead of searching the parent for its name
 				SdFile dir;
-				if (!dir.open(parent, lfilename, O_READ)) {
+				if (!dir.open(&parent, (parent.curPosition() >> 5) - 1, O_READ)) {
 					//SERIAL_ECHO_START();
 					//SERIAL_ECHOPGM(_i("Cannot open subdir"));////MSG_SD_CANT_OPEN_SUBDIR
 					//SERIAL_ECHOLN(lfilename);
@@ -116,7 +131,7 @@ void CardReader::lsDive(const char *prepend, SdFile parent, const char * const m
 				lsDive(path, dir, NULL, lsAction, lsParams);
 				// close() is done automatically by destructor of SdFile
 
-				if (lsParams.LFN)
+				if (lsParams.LFN && !lsParams.compact)
 					puts_P(PSTR("DIR_EXIT"));
 			}
 			else {
@@ -124,6 +139,7 @@ void CardReader::lsDive(const char *prepend, SdFile parent, const char * const m
 				if (!filenameIsDir && (p.name[8] != 'G' || p.name[9] == '~')) continue;
 				switch (lsAction) {
 					case LS_Count:
+						dirIndex.add(nrFiles, position >> 5);
 						nrFiles++;
 						break;
 
@@ -132,19 +148,19 @@ void CardReader::lsDive(const char *prepend, SdFile parent, const char * const m
 						SERIAL_PROTOCOL(prepend);
 						SERIAL_PROTOCOL(filename);
 
+						if (lsParams.compact)
+						{
+							// "<path>,<size>,<timestamp>,<long name>", the long name is the rest of the line
+							printf_P(PSTR(",%lx,%lx,%s\n"), p.fileSize, lsTimestamp(p), longFilename);
+							manage_heater();
+							break;
+						}
+
 						MYSERIAL.write(' ');
 						SERIAL_PROTOCOL(p.fileSize);
 
 						if (lsParams.timestamp)
-						{
-							crmodDate = p.lastWriteDate;
-							crmodTime = p.lastWriteTime;
-							if( crmodDate < p.creationDate || ( crmodDate == p.creationDate && crmodTime < p.creationTime ) ){
-								crmodDate = p.creationDate;
-								crmodTime = p.creationTime;
-							}
-							printf_P(PSTR(" %#lx"), ((uint32_t)crmodDate << 16) | crmodTime);
-						}
+							printf_P(PSTR(" %#lx"), lsTimestamp(p));
 
 						if (lsParams.LFN)
 							printf_P(PSTR(" \"%s\""), LONGEST_FILENAME);
@@ -180,10 +196,12 @@ void CardReader::lsDive(const char *prepend, SdFile parent, const char * const m
 							crmodTime = p.creationTime;
 						}
 						//writeDate = p.lastAccessDate;
-						if (match != NULL) {
-							if (strcasecmp(match, filename) == 0) return;
+						if ((match != NULL) ? (strcasecmp(match, filename) == 0) : (cnt == nrFiles)) {
+							// Read the entry once more to get its whole long name
+							parent.seekSet(position);
+							parent.readDir(&p, longFilename);
+							return;
 						}
-						else if (cnt == nrFiles) return;
 						cnt++;
 						break;
 				}
@@ -242,6 +260,7 @@ void __attribute__((noinline)) CardReader::cdroot(bool doPresort)
   workDir=root;
   workDirDepth = 0;
   curDir=&workDir;
+  dirIndex.reset();
 #ifdef SDCARD_SORT_ALPHA
 	if (doPresort)
 		presort();
@@ -500,6 +519,7 @@ void CardReader::openFileWrite(const char* name)
         SERIAL_PROTOCOLLN('.');
     } else {
         saving = true;
+        dirIndex.reset();
         getfilename(0, fname);
         SERIAL_PROTOCOLRPGM(ofWritingToFile);////MSG_SD_WRITE_TO_FILE
         printAbsFilenameFast();
@@ -526,6 +546,7 @@ void CardReader::removeFile(const char* name)
       SERIAL_PROTOCOLPGM("File deleted:");
       SERIAL_PROTOCOLLN(fname);
       sdpos = 0;
+      dirIndex.reset();
 	  #ifdef SDCARD_SORT_ALPHA
 		  presort();
 	  #endif
@@ -674,11 +695,31 @@ void CardReader::getfilename(uint16_t nr, const char * const match/*=NULL*/)
 {
   curDir=&workDir;
   nrFiles=nr;
-  curDir->rewind();
+  if (match)
+    curDir->rewind();
+  else
+    seekFile(nr);
   lsDive("",*curDir,match, LS_GetFilename);
 
 }
 
+/**
+* Seek the working directory close to the nr-th file using the index built by getnrfilenames()
+* and set nrFiles to the count of files which still need to be skipped by lsDive().
+*/
+void CardReader::seekFile(uint16_t nr)
+{
+	uint16_t entry;
+	const int32_t skip = dirIndex.seek(nr, entry);
+	if (skip < 0) {
+		nrFiles = nr;
+		curDir->rewind();
+	} else {
+		nrFiles = skip;
+		curDir->seekSet((uint32_t)entry << 5);
+	}
+}
+
 void CardReader::getfilename_simple(uint16_t entry, const char * const match/*=NULL*/)
 {
 	curDir = &workDir;
@@ -699,6 +740,7 @@ uint16_t CardReader::getnrfilenames()
 {
   curDir=&workDir;
   nrFiles=0;
+  dirIndex.reset();
   curDir->rewind();
   lsDive("",*curDir, NULL, LS_Count);
   //SERIAL_ECHOLN(nrFiles);
@@ -731,6 +773,7 @@ bool CardReader::chdir(const char * relpath, bool doPresort)
       workDirParents[0]=*parent;
     }
     workDir=newfile;
+    dirIndex.reset();
 
 #ifdef SDCARD_SORT_ALPHA
 	if (doPresort)
@@ -748,6 +791,7 @@ void CardReader::updir()
   {
     --workDirDepth;
     workDir = workDirParents[0];
+    dirIndex.reset();
     for (uint8_t d = 0; d < workDirDepth; d++)
     {
         workDirParents[d] = workDirParents[d+1];
@@ -773,8 +817,13 @@ void CardReader::getfilename_sorted(const uint16_t nr, uint8_t sdSort) {
 void CardReader::getfilename_afterMaxSorting(uint16_t entry, const char * const match/*=NULL*/)
 {
 	curDir = &workDir;
-	nrFiles = entry - sort_count + 1;
-	curDir->seekSet(lastSortedFilePosition << 5);
+	if (match == NULL && dirIndex.count()) {
+		// The files after the sorted ones are listed in the directory order
+		seekFile(entry);
+	} else {
+		nrFiles = entry - sort_count + 1;
+		curDir->seekSet((uint32_t)lastSortedFilePosition << 5);
+	}
 	lsDive("", *curDir, match, LS_GetFilename);
 }
 
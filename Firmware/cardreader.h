@@ -8,6 +8,7 @@
 #define MAX_DIR_DEPTH 6
 
 #include "SdFile.h"
+#include "SdDirIndex.h"
 class CardReader
 {
 public:
@@ -23,8 +24,9 @@ public:
   {
     bool LFN : 1;
     bool timestamp : 1;
-    inline ls_param():LFN(0), timestamp(0) { }
-    inline ls_param(bool LFN, bool timestamp):LFN(LFN), timestamp(timestamp) { }
+    bool compact : 1; //one machine readable line per entry, see M20 C
+    inline ls_param():LFN(0), timestamp(0), compact(0) { }
+    inline ls_param(bool LFN, bool timestamp, bool compact = false):LFN(LFN), timestamp(timestamp), compact(compact) { }
   } __attribute__((packed));
 
   void mount(bool doPresort = true);
@@ -134,9 +136,11 @@ private:
   uint32_t sdpos ;
 
   uint16_t nrFiles; //counter for the files in the current directory and recycled as position counter for getting the nrFiles'th name in the directory.
+  SdDirIndex dirIndex; //checkpoints into the working directory, rebuilt by getnrfilenames()
 
   bool diveSubfolder (const char *&fileName);
-  void lsDive(const char *prepend, SdFile parent, const char * const match=NULL, LsAction lsAction = LS_GetFilename, ls_param lsParams = ls_param());
+  void lsDive(const char *prepend, SdFile &parent, const char * const match=NULL, LsAction lsAction = LS_GetFilename, ls_param lsParams = ls_param());
+  void seekFile(uint16_t nr);
 #ifdef SDCARD_SORT_ALPHA
   void flush_presort();
 #endif
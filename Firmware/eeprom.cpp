@@ -137,6 +137,137 @@ int8_t eeprom_next_initialized_sheet(int8_t sheet)
     return -1;
 }
 
+#define EEPROM_CACHE_SIZE 16
+
+/// Pending byte of the write-behind cache
+struct EepromCacheEntry {
+    uint16_t addr;
+    uint8_t value;
+};
+static EepromCacheEntry eeprom_cache[EEPROM_CACHE_SIZE];
+static uint8_t eeprom_cache_count = 0;
+
+/// Must be called with interrupts disabled
+static int8_t eeprom_cache_find(uint16_t addr) {
+    for (uint8_t i = 0; i < eeprom_cache_count; ++i) {
+        if (eeprom_cache[i].addr == addr)
+            return i;
+    }
+    return -1;
+}
+
+/// Forget the pending bytes which are about to be overwritten directly
+static void eeprom_cache_drop(const void *__p, size_t __n) {
+    if (!eeprom_cache_count)
+        return;
+    uint16_t addr = (uint16_t)__p;
+    CRITICAL_SECTION_START;
+    while (__n--) {
+        const int8_t i = eeprom_cache_find(addr++);
+        if (i >= 0)
+            eeprom_cache[i] = eeprom_cache[--eeprom_cache_count];
+    }
+    CRITICAL_SECTION_END;
+}
+
+/// Write out the last pending byte. The EEPROM needs to be ready, so that the write
+/// only gets started while the interrupts are disabled.
+/// \returns true if the byte differed and a write was started
+static bool eeprom_cache_write_last() {
+    bool changed = false;
+    CRITICAL_SECTION_START;
+    if (eeprom_cache_count) {
+        const EepromCacheEntry &e = eeprom_cache[--eeprom_cache_count];
+        changed = (eeprom_read_byte((uint8_t*)e.addr) != e.value);
+        if (changed)
+            eeprom_write_byte((uint8_t*)e.addr, e.value);
+    }
+    CRITICAL_SECTION_END;
+    return changed;
+}
+
+void eeprom_cache_drain() {
+    while (eeprom_cache_count && eeprom_is_ready()) {
+        if (eeprom_cache_write_last())
+            return;
+    }
+}
+
+void eeprom_cache_flush() {
+    while (eeprom_cache_count) {
+        eeprom_busy_wait();
+        eeprom_cache_write_last();
+    }
+}
+
+void eeprom_cache_read_block(void *__dst, const void *__src, uint8_t __n) {
+    uint8_t *dst = (uint8_t*)__dst;
+    uint16_t addr = (uint16_t)__src;
+    while (__n--) {
+        CRITICAL_SECTION_START;
+        const int8_t i = eeprom_cache_find(addr);
+        if (i >= 0)
+            *dst = eeprom_cache[i].value;
+        CRITICAL_SECTION_END;
+        if (i < 0)
+            *dst = eeprom_read_byte((uint8_t*)addr);
+        ++dst;
+        ++addr;
+    }
+}
+
+uint8_t __attribute__((noinline)) eeprom_cache_read_byte(const uint8_t *__p) {
+    uint8_t value;
+    eeprom_cache_read_block(&value, __p, sizeof(value));
+    return value;
+}
+
+uint16_t __attribute__((noinline)) eeprom_cache_read_word(const uint16_t *__p) {
+    uint16_t value;
+    eeprom_cache_read_block(&value, __p, sizeof(value));
+    return value;
+}
+
+uint32_t __attribute__((noinline)) eeprom_cache_read_dword(const uint32_t *__p) {
+    uint32_t value;
+    eeprom_cache_read_block(&value, __p, sizeof(value));
+    return value;
+}
+
+void eeprom_cache_update_block(const void *__src, void *__dst, uint8_t __n) {
+    const uint8_t *src = (const uint8_t*)__src;
+    uint16_t addr = (uint16_t)__dst;
+    while (__n--) {
+        CRITICAL_SECTION_START;
+        int8_t i = eeprom_cache_find(addr);
+        if (i < 0 && eeprom_cache_count < EEPROM_CACHE_SIZE) {
+            i = eeprom_cache_count++;
+            eeprom_cache[i].addr = addr;
+        }
+        if (i >= 0)
+            eeprom_cache[i].value = *src;
+        CRITICAL_SECTION_END;
+        if (i < 0) {
+            // cache full, write through
+            eeprom_update_byte_notify((uint8_t*)addr, *src);
+        }
+        ++src;
+        ++addr;
+    }
+}
+
+void __attribute__((noinline)) eeprom_cache_update_byte(uint8_t *__p, uint8_t value) {
+    eeprom_cache_update_block(&value, __p, sizeof(value));
+}
+
+void __attribute__((noinline)) eeprom_cache_update_word(uint16_t *__p, uint16_t value) {
+    eeprom_cache_update_block(&value, __p, sizeof(value));
+}
+
+void __attribute__((noinline)) eeprom_cache_update_dword(uint32_t *__p, uint32_t value) {
+    eeprom_cache_update_block(&value, __p, sizeof(value));
+}
+
 #ifdef DEBUG_EEPROM_CHANGES
 static void eeprom_byte_notify(uint8_t *dst, uint8_t previous_value, uint8_t value, bool write) {
     printf_P(PSTR("EEPROMChng b %s %u %d -> %d\n"), write ? "write":"", dst , previous_value, value);
@@ -172,6 +303,7 @@ void eeprom_write_byte_notify(uint8_t *dst, uint8_t value, bool active){
         eeprom_byte_notify(dst, previous_value, value, true);
     }
 #endif //DEBUG_EEPROM_CHANGES
+    eeprom_cache_drop(dst, sizeof(value));
     eeprom_write_byte(dst, value);
 }
 
@@ -187,6 +319,7 @@ void eeprom_update_byte_notify(uint8_t *dst, uint8_t value, bool active){
         }
     }
 #endif //DEBUG_EEPROM_CHANGES
+    eeprom_cache_drop(dst, sizeof(value));
     eeprom_update_byte(dst, value);
 }
 
@@ -199,6 +332,7 @@ void eeprom_write_word_notify(uint16_t *dst, uint16_t value, bool active){
         eeprom_word_notify(dst, previous_value, value, true);
     }
 #endif //DEBUG_EEPROM_CHANGES
+    eeprom_cache_drop(dst, sizeof(value));
     eeprom_write_word(dst, value);
 }
 
@@ -213,6 +347,7 @@ void eeprom_update_word_notify(uint16_t *dst, uint16_t value, bool active){
         }
     }
 #endif //DEBUG_EEPROM_CHANGES
+    eeprom_cache_drop(dst, sizeof(value));
     eeprom_update_word(dst, value);
 }
 
@@ -225,6 +360,7 @@ void eeprom_write_dword_notify(uint32_t *dst, uint32_t value, bool active){
         eeprom_dword_notify(dst, previous_value, value, true);
     }
 #endif //DEBUG_EEPROM_CHANGES
+    eeprom_cache_drop(dst, sizeof(value));
     eeprom_write_dword(dst, value);
 }
 
@@ -239,6 +375,7 @@ void eeprom_update_dword_notify(uint32_t *dst, uint32_t value, bool active){
         }
     }
 #endif //DEBUG_EEPROM_CHANGES
+    eeprom_cache_drop(dst, sizeof(value));
     eeprom_update_dword(dst, value);
 }
 
@@ -251,6 +388,7 @@ void eeprom_write_float_notify(float *dst, float value, bool active){
         eeprom_float_notify(dst, previous_value, value, true);
     }
 #endif //DEBUG_EEPROM_CHANGES
+    eeprom_cache_drop(dst, sizeof(value));
     eeprom_write_float(dst, value);
 }
 
@@ -265,14 +403,17 @@ void eeprom_update_float_notify(float *dst, float value, bool active){
         }
     }
 #endif //DEBUG_EEPROM_CHANGES
+    eeprom_cache_drop(dst, sizeof(value));
     eeprom_update_float(dst, value);
 }
 
 #ifndef DEBUG_EEPROM_CHANGES
 void eeprom_write_block_notify(const void *__src, void *__dst, size_t __n){
+    eeprom_cache_drop(__dst, __n);
     eeprom_write_block(__src, __dst, __n);
 #else
 void eeprom_write_block_notify(const void *__src, void *__dst, size_t __n, bool active){
+    eeprom_cache_drop(__dst, __n);
     if (active) {
         uint8_t previous_values[__n];
         uint8_t new_values[__n];
@@ -286,9 +427,11 @@ void eeprom_write_block_notify(const void *__src, void *__dst, size_t __n, bool
 
 #ifndef DEBUG_EEPROM_CHANGES
 void eeprom_update_block_notify(const void *__src, void *__dst, size_t __n){
+    eeprom_cache_drop(__dst, __n);
     eeprom_update_block(__src, __dst, __n);
 #else
 void eeprom_update_block_notify(const void *__src, void *__dst, size_t __n, bool active){
+    eeprom_cache_drop(__dst, __n);
     if (active) {
         uint8_t previous_values[__n];
         uint8_t new_values[__n];
@@ -335,28 +478,28 @@ void eeprom_toggle(uint8_t *__p) {
 }
 
 void __attribute__((noinline)) eeprom_increment_byte(uint8_t *__p) {
-    eeprom_write_byte_notify(__p, eeprom_read_byte(__p) + 1);
+    eeprom_cache_update_byte(__p, eeprom_cache_read_byte(__p) + 1);
 }
 
 void __attribute__((noinline)) eeprom_increment_word(uint16_t *__p) {
-    eeprom_write_word_notify(__p, eeprom_read_word(__p) + 1);
+    eeprom_cache_update_word(__p, eeprom_cache_read_word(__p) + 1);
 }
 
 void __attribute__((noinline)) eeprom_increment_dword(uint32_t *__p) {
-    eeprom_write_dword_notify(__p, eeprom_read_dword(__p) + 1);
+    eeprom_cache_update_dword(__p, eeprom_cache_read_dword(__p) + 1);
 }
 
 
 void __attribute__((noinline)) eeprom_add_byte(uint8_t *__p, uint8_t add) {
-    eeprom_write_byte_notify(__p, eeprom_read_byte(__p) + add);
+    eeprom_cache_update_byte(__p, eeprom_cache_read_byte(__p) + add);
 }
 
 void __attribute__((noinline)) eeprom_add_word(uint16_t *__p, uint16_t add) {
-    eeprom_write_word_notify(__p, eeprom_read_word(__p) + add);
+    eeprom_cache_update_word(__p, eeprom_cache_read_word(__p) + add);
 }
 
 void __attribute__((noinline)) eeprom_add_dword(uint32_t *__p, uint32_t add) {
-    eeprom_write_dword_notify(__p, eeprom_read_dword(__p) + add);
+    eeprom_cache_update_dword(__p, eeprom_cache_read_dword(__p) + add);
 }
 
 
@@ -417,6 +417,8 @@ static_assert(sizeof(Sheets) == EEPROM_SHEETS_SIZEOF, "Sizeof(Sheets) is not EEP
 | 0x0C11 3089 | uint8   | EEPROM_CHECK_FILAMENT                 | 01h 1        | ffh 255               | Check mode for filament is: __warn__              | LCD menu     | D3 Ax0c11 C1
 | ^           | ^       | ^                                     | 02h 2        | ^                     | Check mode for filament is: __strict__            | ^            | ^
 | ^           | ^       | ^                                     | 00h 0        | ^                     | Check mode for filament is: __none__              | ^            | ^
+| 0x0BAF 2991 | int16   | EEPROM_MBL_CACHE_MESH                 | ???          | ff ffh                | Cached mesh bed leveling points (um) 7x7          | G80 U        | D3 Ax0baf C98
+| 0x0BA3 2979 | struct  | EEPROM_MBL_CACHE_KEY                  | ???          | ffh                   | Sheet, temperatures and age of the cached mesh    | G80 U        | D3 Ax0ba3 C12
 
 
 |Address begin|Bit/Type | Name                                  | Valid values | Default/FactoryReset  | Description                                       |Gcode/Function| Debug code
@@ -668,8 +670,10 @@ static Sheets * const EEPROM_Sheets_base = (Sheets*)(EEPROM_SHEETS_BASE);
 #define EEPROM_UVLO_MIN_SEGMENT_TIME_US (EEPROM_UVLO_MIN_TRAVEL_FEEDRATE-4) //uint32_t
 #define EEPROM_UVLO_MAX_JERK (EEPROM_UVLO_MIN_SEGMENT_TIME_US-4*4) // 4 x float
 #define EEPROM_CHECK_FILAMENT (EEPROM_UVLO_MAX_JERK-1) // uint8_t
+#define EEPROM_MBL_CACHE_MESH (EEPROM_CHECK_FILAMENT-2*7*7) // 7x7 x int16_t
+#define EEPROM_MBL_CACHE_KEY (EEPROM_MBL_CACHE_MESH-12) // mbl_cache_key_t
 //This is supposed to point to last item to allow EEPROM overrun check. Please update when adding new items.
-#define EEPROM_LAST_ITEM EEPROM_CHECK_FILAMENT
+#define EEPROM_LAST_ITEM EEPROM_MBL_CACHE_KEY
 // !!!!!
 // !!!!! this is end of EEPROM section ... all updates MUST BE inserted before this mark !!!!!
 // !!!!!
@@ -716,6 +720,27 @@ bool eeprom_is_initialized_block(const void *__p, size_t __n);
 void eeprom_update_block_P(const void *__src, void *__dst, size_t __n);
 void eeprom_toggle(uint8_t *__p);
 
+/// @name Write-behind cache
+/// Statistics counters are updated through a small RAM cache instead of blocking the main loop
+/// for ~3.3ms per EEPROM byte. Pending bytes are written one by one from manage_inactivity()
+/// and all at once on power panic and before a reset. The *_notify() functions write through
+/// and drop the cached bytes they overwrite. Use eeprom_cache_read_*() to read values which
+/// may be pending.
+///@{
+void eeprom_cache_read_block(void *__dst, const void *__src, uint8_t __n);
+uint8_t eeprom_cache_read_byte(const uint8_t *__p);
+uint16_t eeprom_cache_read_word(const uint16_t *__p);
+uint32_t eeprom_cache_read_dword(const uint32_t *__p);
+void eeprom_cache_update_block(const void *__src, void *__dst, uint8_t __n);
+void eeprom_cache_update_byte(uint8_t *__p, uint8_t value);
+void eeprom_cache_update_word(uint16_t *__p, uint16_t value);
+void eeprom_cache_update_dword(uint32_t *__p, uint32_t value);
+/// Start writing the next pending byte if the EEPROM is not busy, never waits
+void eeprom_cache_drain();
+/// Write all pending bytes, waits for the EEPROM. Can be called with interrupts disabled.
+void eeprom_cache_flush();
+///@}
+
 void eeprom_increment_byte(uint8_t *__p);
 void eeprom_increment_word(uint16_t *__p);
 void eeprom_increment_dword(uint32_t *__p);
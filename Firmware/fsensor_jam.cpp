@@ -0,0 +1,22 @@
+/// @file
+#include "fsensor_jam.h"
+
+uint8_t FSensorJamDetector::failures() const {
+    uint8_t n = 0;
+    for (uint8_t h = history; h; h &= h - 1)
+        ++n;
+    return n;
+}
+
+bool FSensorJamDetector::chunk(int16_t steps, int16_t motion) {
+    const bool follows = (steps > 0) ? (motion >= FSENSOR_JAM_MIN_MOTION) : (motion <= -FSENSOR_JAM_MIN_MOTION);
+    history = (uint8_t)((history << 1) | (follows ? 0 : 1));
+#if FSENSOR_JAM_WINDOW < 8
+    history &= (1 << FSENSOR_JAM_WINDOW) - 1;
+#endif
+    if (failures() >= FSENSOR_JAM_THRESHOLD) {
+        history = 0;
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,30 @@
+/// @file
+/// Filament jam detection from the extruder steps and the optical filament sensor motion.
+#pragma once
+#include <stdint.h>
+
+#define FSENSOR_JAM_WINDOW    8 // chunks kept in the history
+#define FSENSOR_JAM_THRESHOLD 6 // chunks of the window in which the filament did not follow the extruder
+#define FSENSOR_JAM_MIN_MOTION 2 // sensor counts per chunk to tell motion from vibrations
+
+/// Compares the extruder steps done in a chunk with the filament motion seen by the sensor
+/// over the same time. The filament follows if it moved at least FSENSOR_JAM_MIN_MOTION counts
+/// in the direction of the extruder, no motion counts as not following in both directions.
+class FSensorJamDetector {
+public:
+    void reset() { history = 0; }
+
+    /// @param steps extruder steps done in the chunk, signed
+    /// @param motion sensor counts over the same time, signed
+    /// @return true if the filament did not follow in FSENSOR_JAM_THRESHOLD of the last
+    ///         FSENSOR_JAM_WINDOW chunks. The history is cleared then.
+    bool chunk(int16_t steps, int16_t motion);
+
+    /// @return number of chunks in the window in which the filament did not follow
+    uint8_t failures() const;
+
+private:
+    uint8_t history = 0; ///< one bit per chunk, newest in bit 0, set if the filament did not follow
+};
+
+static_assert(FSENSOR_JAM_WINDOW <= 8, "history is kept in an uint8_t");
@@ -0,0 +1,132 @@
+//! @file
+//! @brief Main loop latency statistics and blocking call tracer
+
+#include "loop_stats.h"
+
+#ifdef LOOP_STATS
+
+#include "Marlin.h"
+
+struct LoopStageStats {
+    uint32_t max_us;
+    uint16_t hist[LOOP_STATS_BUCKETS]; // saturating
+};
+
+static LoopStageStats stage_stats[(uint8_t)LoopStage::count];
+static uint32_t loop_start_us;
+static uint32_t mark_us;
+static bool loop_started;
+
+static struct {
+    uint32_t duration_us;
+    uint32_t timestamp_ms;
+    BlockingCall call;
+} longest_blocking;
+
+static const char stage_loop[] PROGMEM = "loop";
+static const char stage_get_command[] PROGMEM = "get_command";
+static const char stage_process_commands[] PROGMEM = "process_commands";
+static const char stage_manage_heater[] PROGMEM = "manage_heater";
+static const char stage_manage_inactivity[] PROGMEM = "manage_inactivity";
+static const char stage_lcd_update[] PROGMEM = "lcd_update";
+static const char stage_drivers[] PROGMEM = "drivers";
+static const char * const stage_names[] PROGMEM = {
+    stage_loop, stage_get_command, stage_process_commands,
+    stage_manage_heater, stage_manage_inactivity, stage_lcd_update, stage_drivers,
+};
+static_assert(sizeof(stage_names) / sizeof(stage_names[0]) == (uint8_t)LoopStage::count, "missing stage name");
+
+static const char call_none[] PROGMEM = "none";
+static const char call_plan_buffer_line[] PROGMEM = "plan_buffer_line";
+static const char call_st_synchronize[] PROGMEM = "st_synchronize";
+static const char call_delay_keep_alive[] PROGMEM = "delay_keep_alive";
+static const char * const call_names[] PROGMEM = {
+    call_none, call_plan_buffer_line, call_st_synchronize, call_delay_keep_alive,
+};
+
+static void stage_record(LoopStage stage, uint32_t us)
+{
+    LoopStageStats &s = stage_stats[(uint8_t)stage];
+    if (us > s.max_us) s.max_us = us;
+
+    // log2 bucket of the duration in (binary) milliseconds, saturated before narrowing
+    uint32_t ms32 = us >> 10;
+    uint16_t ms = (ms32 > UINT16_MAX)? UINT16_MAX: ms32;
+    uint8_t bucket = 0;
+    while (ms && bucket < LOOP_STATS_BUCKETS - 1) {
+        ms >>= 1;
+        ++bucket;
+    }
+    if (s.hist[bucket] != UINT16_MAX)
+        ++s.hist[bucket];
+}
+
+void loop_stats_begin()
+{
+    uint32_t now = _micros();
+    if (loop_started)
+        stage_record(LoopStage::loop, now - loop_start_us);
+    loop_started = true;
+    loop_start_us = mark_us = now;
+}
+
+void loop_stats_mark(LoopStage stage)
+{
+    uint32_t now = _micros();
+    stage_record(stage, now - mark_us);
+    mark_us = now;
+}
+
+void loop_stats_blocking(BlockingCall call, uint32_t start_us)
+{
+    uint32_t duration = _micros() - start_us;
+    if (duration > longest_blocking.duration_us) {
+        longest_blocking.duration_us = duration;
+        longest_blocking.timestamp_ms = _millis();
+        longest_blocking.call = call;
+    }
+}
+
+void loop_stats_reset()
+{
+    memset(stage_stats, 0, sizeof(stage_stats));
+    memset(&longest_blocking, 0, sizeof(longest_blocking));
+    loop_started = false;
+}
+
+//! Upper bound of the bucket containing the given percentile, in ms (128 for the open-ended last bucket)
+static uint8_t stage_percentile(const LoopStageStats &s, uint8_t percent)
+{
+    uint32_t total = 0;
+    for (uint8_t i = 0; i < LOOP_STATS_BUCKETS; ++i)
+        total += s.hist[i];
+    uint32_t limit = (total * percent + 99) / 100;
+    uint32_t acc = 0;
+    for (uint8_t i = 0; i < LOOP_STATS_BUCKETS; ++i) {
+        acc += s.hist[i];
+        if (acc >= limit)
+            return 1 << i;
+    }
+    return 1 << (LOOP_STATS_BUCKETS - 1);
+}
+
+void loop_stats_report(bool verbose)
+{
+    for (uint8_t i = 0; i < (uint8_t)LoopStage::count; ++i) {
+        const LoopStageStats &s = stage_stats[i];
+        printf_P(PSTR("%S max:%luus p50:%ums p90:%ums p99:%ums"),
+            pgm_read_ptr(&stage_names[i]), s.max_us,
+            stage_percentile(s, 50), stage_percentile(s, 90), stage_percentile(s, 99));
+        if (verbose) {
+            printf_P(PSTR(" hist:"));
+            for (uint8_t b = 0; b < LOOP_STATS_BUCKETS; ++b)
+                printf_P(PSTR(" %u"), s.hist[b]);
+        }
+        putchar('\n');
+    }
+    printf_P(PSTR("longest blocking: %S %luus at %lums\n"),
+        pgm_read_ptr(&call_names[(uint8_t)longest_blocking.call]),
+        longest_blocking.duration_us, longest_blocking.timestamp_ms);
+}
+
+#endif //LOOP_STATS
@@ -0,0 +1,47 @@
+//! @file
+//! @brief Main loop latency statistics and blocking call tracer
+
+#pragma once
+
+#include <stdint.h>
+#include "Configuration.h"
+
+#ifdef LOOP_STATS
+
+//! Stages of the main loop, timed individually
+enum class LoopStage : uint8_t {
+    loop,              //!< whole loop() iteration
+    get_command,       //!< get_command() and SD autostart
+    process_commands,  //!< process_commands() including the blocking calls it makes
+    manage_heater,
+    manage_inactivity,
+    lcd_update,
+    drivers,           //!< TMC2130 overtemperature and crash checks, MMU loop
+    count
+};
+
+//! Calls which block the main loop while waiting for something else
+enum class BlockingCall : uint8_t {
+    none,
+    plan_buffer_line,  //!< waiting for a free planner block
+    st_synchronize,    //!< waiting for the planner queue to drain
+    delay_keep_alive,  //!< explicit delay
+};
+
+#define LOOP_STATS_BUCKETS 8 //!< histogram buckets: <1ms, <2ms, <4ms ... <64ms, >=64ms
+
+//! Start of a loop() iteration: accounts the previous iteration as LoopStage::loop
+void loop_stats_begin();
+
+//! Account the time since the previous mark (or loop_stats_begin()) to @p stage
+void loop_stats_mark(LoopStage stage);
+
+//! Record a blocking call which started at @p start_us (_micros() timestamp)
+void loop_stats_blocking(BlockingCall call, uint32_t start_us);
+
+void loop_stats_reset();
+
+//! Print the statistics, @p verbose includes the per-stage histograms
+void loop_stats_report(bool verbose);
+
+#endif //LOOP_STATS
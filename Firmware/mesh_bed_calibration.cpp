@@ -926,9 +926,12 @@ static inline void update_current_position_z()
       plan_set_z_position(current_position[Z_AXIS]);
 }
 
+// Two consecutive touches closer than this are taken as the result in the BED_PROBE_EARLY_EXIT mode.
+#define FIND_BED_INDUCTION_SENSOR_POINT_Z_AGREEMENT (0.01f)
+
 // At the current position, find the Z stop.
 
-bool find_bed_induction_sensor_point_z(float minimum_z, uint8_t n_iter, int
+bool find_bed_induction_sensor_point_z(float minimum_z, uint8_t n_iter, uint8_t flags, int
 #ifdef SUPPORT_VERBOSITY
     verbosity_level
 #endif //SUPPORT_VERBOSITY
@@ -953,27 +956,32 @@ bool find_bed_induction_sensor_point_z(float minimum_z, uint8_t n_iter, int
     float z = 0.f;
     endstop_z_hit_on_purpose();
 
-    // move down until you find the bed
-    current_position[Z_AXIS] = minimum_z;
-    go_to_current(homing_feedrate[Z_AXIS]/60);
-    // we have to let the planner know where we are right now as it is not where we said to go.
-    update_current_position_z();
-    if (! endstop_z_hit_on_purpose())
-	{
-		//printf_P(PSTR("endstop not hit 1, current_pos[Z]: %f \n"), current_position[Z_AXIS]);
-		goto error;
-	}
+    if (!(flags & BED_PROBE_FROM_CURRENT))
+    {
+        // move down until you find the bed
+        current_position[Z_AXIS] = minimum_z;
+        go_to_current(homing_feedrate[Z_AXIS]/60);
+        // we have to let the planner know where we are right now as it is not where we said to go.
+        update_current_position_z();
+        if (! endstop_z_hit_on_purpose())
+        {
+            //printf_P(PSTR("endstop not hit 1, current_pos[Z]: %f \n"), current_position[Z_AXIS]);
+            goto error;
+        }
 #ifdef TMC2130
-	if (!READ(Z_TMC2130_DIAG))
-	{
-		//printf_P(PSTR("crash detected 1, current_pos[Z]: %f \n"), current_position[Z_AXIS]);
-		goto error; //crash Z detected
-	}
+        if (!READ(Z_TMC2130_DIAG))
+        {
+            //printf_P(PSTR("crash detected 1, current_pos[Z]: %f \n"), current_position[Z_AXIS]);
+            goto error; //crash Z detected
+        }
 #endif //TMC2130
+    }
     for (uint8_t i = 0; i < n_iter; ++ i)
 	{
 
-		current_position[Z_AXIS] += high_deviation_occured ? 0.5 : 0.2;
+		// The caller already placed the sensor just above the predicted bed height, the first slow approach starts from there
+		if (i || high_deviation_occured || !(flags & BED_PROBE_FROM_CURRENT))
+			current_position[Z_AXIS] += high_deviation_occured ? 0.5 : 0.2;
 		float z_bckp = current_position[Z_AXIS];
 		go_to_current(homing_feedrate[Z_AXIS]/60);
 		// Move back down slowly to find bed.
@@ -1010,6 +1018,11 @@ bool find_bed_induction_sensor_point_z(float minimum_z, uint8_t n_iter, int
 //        SERIAL_ECHOLNPGM("");
 		float dz = i?fabs(current_position[Z_AXIS] - (z / i)):0;
         z += current_position[Z_AXIS];
+		if ((flags & BED_PROBE_EARLY_EXIT) && i && dz < FIND_BED_INDUCTION_SENSOR_POINT_Z_AGREEMENT) {
+			// the touches agree, further samples would not change the average noticeably
+			n_iter = i + 1;
+			break;
+		}
 		//printf_P(PSTR("Z[%d] = %d, dz=%d\n"), i, (int)(current_position[Z_AXIS] * 1000), (int)(dz * 1000));
 		//printf_P(PSTR("Z- measurement deviation from avg value %f um\n"), dz);
 		if (dz > 0.05) { //deviation > 50um
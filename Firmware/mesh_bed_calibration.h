@@ -176,7 +176,13 @@ enum BedSkewOffsetDetectionResultType : int8_t {
 	BED_SKEW_OFFSET_DETECTION_SKEW_EXTREME		= 2   //!< Extremely skewed.
 };
 
-bool find_bed_induction_sensor_point_z(float minimum_z = -10.f, uint8_t n_iter = 3, int verbosity_level = 0);
+/// find_bed_induction_sensor_point_z() options
+enum BedProbeFlags : uint8_t {
+	BED_PROBE_EARLY_EXIT   = 1, //!< Stop as soon as two touches agree, n_iter is the maximum number of touches.
+	BED_PROBE_FROM_CURRENT = 2, //!< The sensor is already placed just above the predicted bed height, skip the fast touch.
+};
+
+bool find_bed_induction_sensor_point_z(float minimum_z = -10.f, uint8_t n_iter = 3, uint8_t flags = 0, int verbosity_level = 0);
 BedSkewOffsetDetectionResultType find_bed_induction_sensor_point_xy(int verbosity_level = 0);
 void go_home_with_z_lift();
 
@@ -1,6 +1,13 @@
 #include "mesh_bed_leveling.h"
 #include "mesh_bed_calibration.h"
 #include "Configuration.h"
+#include "eeprom.h"
+#include "temperature.h"
+
+#ifdef MBL_CACHE
+#include <stddef.h>
+#include <util/crc16.h>
+#endif //MBL_CACHE
 
 #ifdef MESH_BED_LEVELING
 
@@ -100,4 +107,80 @@ void mesh_bed_leveling::print() {
     }
 }
 
+#ifdef MBL_CACHE
+static_assert(MESH_NUM_X_POINTS * MESH_NUM_Y_POINTS == 7 * 7, "EEPROM_MBL_CACHE_MESH holds a 7x7 mesh");
+
+typedef struct __attribute__((packed))
+{
+    uint8_t points;       //!< measured grid, 3 or 7
+    uint8_t sheet;        //!< active steel sheet
+    uint8_t bed_temp;     //!< target bed temperature
+    uint8_t pinda_temp;   //!< PINDA temperature, 0 without the thermistor
+    uint16_t calibration; //!< CRC of the XYZ calibration, changes with every recalibration
+    uint32_t time;        //!< total print time (min) at the time of probing
+    uint16_t crc;         //!< CRC of the previous fields and the cached mesh
+} mbl_cache_key_t;
+
+static_assert(sizeof(mbl_cache_key_t) == EEPROM_MBL_CACHE_MESH - EEPROM_MBL_CACHE_KEY, "EEPROM_MBL_CACHE_KEY size");
+
+static uint16_t mbl_cache_crc_eeprom(uint16_t crc, const uint8_t *addr, uint8_t size) {
+    while (size--)
+        crc = _crc_ccitt_update(crc, eeprom_read_byte(addr++));
+    return crc;
+}
+
+static void mbl_cache_key(uint8_t points, mbl_cache_key_t &key) {
+    key.points = points;
+    key.sheet = eeprom_read_byte(&(EEPROM_Sheets_base->active_sheet));
+    key.bed_temp = target_temperature_bed;
+#ifdef PINDA_THERMISTOR
+    key.pinda_temp = uint8_t(current_temperature_pinda + 0.5f);
+#else
+    key.pinda_temp = 0;
+#endif //PINDA_THERMISTOR
+    key.calibration = mbl_cache_crc_eeprom(0xffff, (const uint8_t*)EEPROM_BED_CALIBRATION_Z_JITTER,
+        EEPROM_BED_CALIBRATION_CENTER + 2*4 - EEPROM_BED_CALIBRATION_Z_JITTER);
+    key.time = eeprom_cache_read_dword((uint32_t*)EEPROM_TOTALTIME);
+}
+
+static uint16_t mbl_cache_crc(const mbl_cache_key_t &key) {
+    uint16_t crc = 0xffff;
+    for (uint8_t i = 0; i < offsetof(mbl_cache_key_t, crc); ++i)
+        crc = _crc_ccitt_update(crc, ((const uint8_t*)&key)[i]);
+    return mbl_cache_crc_eeprom(crc, (const uint8_t*)EEPROM_MBL_CACHE_MESH, 2 * MESH_NUM_X_POINTS * MESH_NUM_Y_POINTS);
+}
+
+bool mbl_cache_valid(uint8_t points) {
+    mbl_cache_key_t key, cached;
+    mbl_cache_key(points, key);
+    eeprom_read_block(&cached, (const void*)EEPROM_MBL_CACHE_KEY, sizeof(cached));
+    return (cached.crc == mbl_cache_crc(cached))
+        && (cached.points == key.points)
+        && (cached.sheet == key.sheet)
+        && (cached.bed_temp == key.bed_temp)
+        && (abs(int16_t(cached.pinda_temp) - int16_t(key.pinda_temp)) <= MBL_CACHE_PINDA_TOLERANCE)
+        && (cached.calibration == key.calibration)
+        && (key.time - cached.time <= MBL_CACHE_MAX_AGE); // also rejects a reset print time
+}
+
+float mbl_cache_z(uint8_t ix, uint8_t iy) {
+    const uint16_t v = eeprom_read_word((uint16_t*)EEPROM_MBL_CACHE_MESH + iy * MESH_NUM_X_POINTS + ix);
+    return int16_t(v) * 0.001f;
+}
+
+void mbl_cache_save(uint8_t points) {
+    for (uint8_t iy = 0; iy < MESH_NUM_Y_POINTS; ++iy) {
+        for (uint8_t ix = 0; ix < MESH_NUM_X_POINTS; ++ix) {
+            const int16_t v = int16_t(floor(mbl.z_values[iy][ix] * 1000.f + 0.5f));
+            eeprom_update_word_notify((uint16_t*)EEPROM_MBL_CACHE_MESH + iy * MESH_NUM_X_POINTS + ix, uint16_t(v));
+        }
+    }
+    // The key goes last, an interrupted save leaves a CRC mismatch
+    mbl_cache_key_t key;
+    mbl_cache_key(points, key);
+    key.crc = mbl_cache_crc(key);
+    eeprom_update_block_notify(&key, (void*)EEPROM_MBL_CACHE_KEY, sizeof(key));
+}
+#endif //MBL_CACHE
+
 #endif  // MESH_BED_LEVELING
@@ -22,4 +22,16 @@ public:
 
 extern mesh_bed_leveling mbl;
 
+#ifdef MBL_CACHE
+/// @return true if the cached mesh was measured with the given grid (3 or 7 points), on the active sheet,
+/// at the current bed target and PINDA temperature, with the current XYZ calibration and is not older than MBL_CACHE_MAX_AGE
+bool mbl_cache_valid(uint8_t points);
+
+/// @return cached height of a mesh point
+float mbl_cache_z(uint8_t ix, uint8_t iy);
+
+/// Store the mesh just measured with the given grid
+void mbl_cache_save(uint8_t points);
+#endif //MBL_CACHE
+
 #endif  // MESH_BED_LEVELING
@@ -0,0 +1,35 @@
+/// @file
+#include "mesh_probe_order.h"
+
+uint8_t mesh_probe_order(const uint8_t* row_mask, uint8_t nx, uint8_t ny, uint8_t ix_start, uint8_t* order)
+{
+    uint8_t n = 0;
+    uint8_t ix_last = ix_start;
+    for (uint8_t iy = 0; iy < ny; ++iy)
+    {
+        const uint8_t mask = row_mask[iy];
+        if (!mask)
+            continue;
+
+        // Outermost points of the row
+        uint8_t first = 0;
+        while (!(mask & (1 << first)))
+            ++first;
+        uint8_t last = nx - 1;
+        while (!(mask & (1 << last)))
+            --last;
+
+        const uint8_t d_first = (ix_last > first) ? ix_last - first : first - ix_last;
+        const uint8_t d_last = (ix_last > last) ? ix_last - last : last - ix_last;
+        const bool reverse = d_last < d_first;
+
+        for (uint8_t i = 0; i < nx; ++i)
+        {
+            const uint8_t ix = reverse ? (nx - 1 - i) : i;
+            if (mask & (1 << ix))
+                order[n++] = iy * nx + ix;
+        }
+        ix_last = reverse ? first : last;
+    }
+    return n;
+}
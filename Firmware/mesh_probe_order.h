@@ -0,0 +1,15 @@
+/// @file
+/// Visiting order of the mesh bed leveling probe points.
+#pragma once
+#include <stdint.h>
+
+/// Order the points of a probing grid to keep the travel short.
+/// Rows are visited from the front to the back, each row is entered from the end
+/// closer to the last probed point. A full grid started from the left results in the usual zig-zag.
+/// @param row_mask bit ix of row_mask[iy] is set for every point to be probed (nx <= 8)
+/// @param nx number of columns
+/// @param ny number of rows
+/// @param ix_start column closest to the initial head position
+/// @param order receives the point indices iy * nx + ix
+/// @return number of points in order
+uint8_t mesh_probe_order(const uint8_t* row_mask, uint8_t nx, uint8_t ny, uint8_t ix_start, uint8_t* order);
@@ -71,7 +71,17 @@ void mc_arc(const float* position, float* target, const float* offset, float fee
     else if (mm_per_arc_segment > cs.mm_per_arc_segment) {
         // 20210113 - This can be implemented in an else if since  we can't be below the min AND above the max at the same time.
         // 20200417 - FormerLurker - Implement MIN_MM_PER_ARC_SEGMENT if it is defined
-        mm_per_arc_segment = cs.mm_per_arc_segment;
+        float max_mm_per_arc_segment = cs.mm_per_arc_segment;
+        if (cs.arc_max_chord_error > 0) {
+            // A chord of length l on a circle of radius r deviates from the arc by e = r - sqrt(r^2 - l^2/4) ~= l^2 / (8r).
+            // On large radii the fixed maximum produces far more segments than needed to stay within the tolerance,
+            // each costing a full plan_buffer_line(), so let the segment grow until the chord error hits the limit.
+            const float chord_mm_per_arc_segment = sqrt((8.f * cs.arc_max_chord_error) * radius);
+            if (chord_mm_per_arc_segment > max_mm_per_arc_segment)
+                max_mm_per_arc_segment = chord_mm_per_arc_segment;
+        }
+        if (mm_per_arc_segment > max_mm_per_arc_segment)
+            mm_per_arc_segment = max_mm_per_arc_segment;
     }
 
     // Adjust the angular travel if the direction is clockwise
@@ -43,6 +43,11 @@ int16_t pat9125_y = 0;
 uint8_t pat9125_b = 0;
 uint8_t pat9125_s = 0;
 
+#if defined(PAT9125_SWI2C)
+// Sequential reads work (checked by pat9125_init() on the product ID registers)
+static bool pat9125_burst = false;
+#endif //PAT9125_SWI2C
+
 
 // Init sequence, address & value.
 const PROGMEM uint8_t pat9125_init_bank0[] = {
@@ -96,6 +101,9 @@ const PROGMEM uint8_t pat9125_init_bank1[] = {
 
 
 static uint8_t pat9125_rd_reg(uint8_t addr);
+#if defined(PAT9125_SWI2C)
+static uint8_t pat9125_rd_seq(uint8_t addr, uint8_t* data, uint8_t cnt);
+#endif //PAT9125_SWI2C
 static void pat9125_wr_reg(uint8_t addr, uint8_t data);
 static uint8_t pat9125_wr_reg_verify(uint8_t addr, uint8_t data);
 static uint8_t pat9125_wr_seq(const uint8_t* seq);
@@ -173,13 +181,45 @@ uint8_t pat9125_init(void)
 	pat9125_wr_reg(PAT9125_WP, 0x00); //prevents writing to registers over 0x09
 #endif //PAT9125_NEW_INIT
 
+#if defined(PAT9125_SWI2C)
+	// Use burst reads only if the sensor returns both product ID registers in one go.
+	// A NACK here only disables them, the product ID read above stays valid.
+	uint8_t pid[2];
+	pat9125_burst = swi2c_readBlock_A8(PAT9125_I2C_ADDR, PAT9125_PID1, pid, 2) && (pid[0] == 0x31) && (pid[1] == 0x91);
+#endif //PAT9125_SWI2C
+
 	return 1;
 }
 
+static void pat9125_add_delta(uint16_t ucXL, uint16_t ucYL, uint16_t ucXYH)
+{
+	int16_t iDX = ucXL | ((ucXYH << 4) & 0xf00);
+	int16_t iDY = ucYL | ((ucXYH << 8) & 0xf00);
+	if (iDX & 0x800) iDX -= 4096;
+	if (iDY & 0x800) iDY -= 4096;
+	pat9125_x += iDX;
+	pat9125_y += iDY;
+}
+
 uint8_t pat9125_update(void)
 {
 	if ((pat9125_PID1 == 0x31) && (pat9125_PID2 == 0x91))
 	{
+#if defined(PAT9125_SWI2C)
+		if (pat9125_burst)
+		{
+			// MOTION, DELTA_XL, DELTA_YL and DELTA_XYH ... FRAME in two transactions
+			uint8_t motion[3];
+			uint8_t high[PAT9125_FRAME - PAT9125_DELTA_XYH + 1];
+			if (!pat9125_rd_seq(PAT9125_MOTION, motion, sizeof(motion))) return 0;
+			if (!pat9125_rd_seq(PAT9125_DELTA_XYH, high, sizeof(high))) return 0;
+			pat9125_s = high[PAT9125_SHUTTER - PAT9125_DELTA_XYH];
+			pat9125_b = high[PAT9125_FRAME - PAT9125_DELTA_XYH];
+			// the deltas read as zero without motion
+			pat9125_add_delta(motion[1], motion[2], high[0]);
+			return 1;
+		}
+#endif //PAT9125_SWI2C
 		uint8_t ucMotion = pat9125_rd_reg(PAT9125_MOTION);
 		pat9125_b = pat9125_rd_reg(PAT9125_FRAME);
 		pat9125_s = pat9125_rd_reg(PAT9125_SHUTTER);
@@ -190,12 +230,7 @@ uint8_t pat9125_update(void)
 			uint16_t ucYL = pat9125_rd_reg(PAT9125_DELTA_YL);
 			uint16_t ucXYH = pat9125_rd_reg(PAT9125_DELTA_XYH);
 			if (pat9125_PID1 == 0xff) return 0;
-			int16_t iDX = ucXL | ((ucXYH << 4) & 0xf00);
-			int16_t iDY = ucYL | ((ucXYH << 8) & 0xf00);
-			if (iDX & 0x800) iDX -= 4096;
-			if (iDY & 0x800) iDY -= 4096;
-			pat9125_x += iDX;
-			pat9125_y += iDY;
+			pat9125_add_delta(ucXL, ucYL, ucXYH);
 		}
 		return 1;
 	}
@@ -206,6 +241,23 @@ uint8_t pat9125_update_y(void)
 {
 	if ((pat9125_PID1 == 0x31) && (pat9125_PID2 == 0x91))
 	{
+#if defined(PAT9125_SWI2C)
+		if (pat9125_burst)
+		{
+			uint8_t motion[3]; // MOTION, DELTA_XL, DELTA_YL
+			if (!pat9125_rd_seq(PAT9125_MOTION, motion, sizeof(motion))) return 0;
+			// the deltas were read already, motion may have been detected just after MOTION
+			if ((motion[0] & 0x80) || motion[1] || motion[2])
+			{
+				uint16_t ucXYH = pat9125_rd_reg(PAT9125_DELTA_XYH);
+				if (pat9125_PID1 == 0xff) return 0;
+				int16_t iDY = motion[2] | ((ucXYH << 8) & 0xf00);
+				if (iDY & 0x800) iDY -= 4096;
+				pat9125_y += iDY;
+			}
+			return 1;
+		}
+#endif //PAT9125_SWI2C
 		uint8_t ucMotion = pat9125_rd_reg(PAT9125_MOTION);
 		if (pat9125_PID1 == 0xff) return 0;
 		if (ucMotion & 0x80)
@@ -252,6 +304,21 @@ static uint8_t pat9125_rd_reg(uint8_t addr)
     return 0;
 }
 
+#if defined(PAT9125_SWI2C)
+// Reads cnt consecutive registers in a single transaction
+static uint8_t pat9125_rd_seq(uint8_t addr, uint8_t* data, uint8_t cnt)
+{
+	if (!swi2c_readBlock_A8(PAT9125_I2C_ADDR, addr, data, cnt)) //NO ACK error
+        goto error;
+	return 1;
+
+ error:
+    pat9125_PID1 = 0xff;
+    pat9125_PID2 = 0xff;
+    return 0;
+}
+#endif //PAT9125_SWI2C
+
 static void pat9125_wr_reg(uint8_t addr, uint8_t data)
 {
 #if defined(PAT9125_SWI2C)
@@ -54,6 +54,8 @@
 #include "Marlin.h"
 #include "planner.h"
 #include "stepper.h"
+#include "speed_lookuptable.h"
+#include "loop_stats.h"
 #include "temperature.h"
 #include "fancheck.h"
 #include "ultralcd.h"
@@ -110,6 +112,11 @@ volatile uint8_t block_buffer_tail;         // Index of the block to process now
 static uint8_t g_cntr_planner_queue_min = 0;
 #endif /* PLANNER_DIAGNOSTICS */
 
+#ifdef PLANNER_STATS
+planner_stats_t planner_stats;
+volatile bool planner_stats_waiting;
+#endif /* PLANNER_STATS */
+
 //===========================================================================
 //=============================private variables ============================
 //===========================================================================
@@ -697,12 +704,18 @@ void plan_buffer_line(float x, float y, float z, const float &e, float feed_rate
   // If the buffer is full: good! That means we are well ahead of the robot.
   // Rest here until there is room in the buffer.
   if (block_buffer_tail == next_buffer_head) {
+#ifdef LOOP_STATS
+      const uint32_t start_us = _micros();
+#endif //LOOP_STATS
       do {
           manage_heater();
           // Vojtech: Don't disable motors inside the planner!
           manage_inactivity(false);
           lcd_update(0);
       } while (block_buffer_tail == next_buffer_head);
+#ifdef LOOP_STATS
+      loop_stats_blocking(BlockingCall::plan_buffer_line, start_us);
+#endif //LOOP_STATS
   }
 #ifdef PLANNER_DIAGNOSTICS
   planner_update_queue_min_counter();
@@ -1195,6 +1208,10 @@ Having the real displacement of the head, we can calculate the total movement le
   }
 #endif
 
+  // Precompute the steady state timer interval, so that the stepper isr doesn't have to
+  // interpolate the speed lookup table when the cruising phase is entered.
+  block->nominal_timer = calc_timer(uint16_t(block->nominal_rate), block->nominal_step_loops);
+
   calculate_trapezoid_for_block(block, block->entry_speed, safe_speed);
 
   if (block->step_event_count.wide <= 32767)
@@ -1330,6 +1347,29 @@ void planner_queue_min_reset()
 }
 #endif /* PLANNER_DIAGNOSTICS */
 
+#ifdef PLANNER_STATS
+void planner_stats_reset()
+{
+  CRITICAL_SECTION_START;
+  memset(&planner_stats, 0, sizeof(planner_stats));
+  CRITICAL_SECTION_END;
+}
+
+void planner_stats_report()
+{
+  planner_stats_t stats;
+  CRITICAL_SECTION_START;
+  stats = planner_stats;
+  CRITICAL_SECTION_END;
+
+  const uint8_t width = BLOCK_BUFFER_SIZE / PLANNER_STATS_BUCKETS;
+  SERIAL_ECHOPGM("queue");
+  for (uint8_t i = 0; i < PLANNER_STATS_BUCKETS; ++i)
+      printf_P(PSTR(" %u-%u:%lu"), i * width, (i + 1) * width - 1, stats.queue_hist[i]);
+  printf_P(PSTR("\nstarved sd:%u usb:%u\n"), stats.starved_sd, stats.starved_usb);
+}
+#endif /* PLANNER_STATS */
+
 void planner_add_sd_length(uint16_t sdlen)
 {
   if (block_buffer_head != block_buffer_tail) {
@@ -99,6 +99,8 @@ typedef struct {
   uint32_t initial_rate;              // The jerk-adjusted step rate at start of block
   uint32_t final_rate;                // The minimal rate at exit
   uint32_t acceleration_steps_per_s2; // acceleration steps/sec^2
+  uint16_t nominal_timer;             // Timer interval of the steady state, precomputed from nominal_rate
+  uint8_t nominal_step_loops;         // Steps per interrupt in the steady state
   uint8_t fan_speed; // Print fan speed, ranges from 0 to 255
   volatile char busy;
 
@@ -256,6 +258,29 @@ extern uint8_t planner_queue_min();
 extern void planner_queue_min_reset();
 #endif /* PLANNER_DIAGNOSTICS */
 
+#ifdef PLANNER_STATS
+#define PLANNER_STATS_BUCKETS 8
+static_assert(!(BLOCK_BUFFER_SIZE % PLANNER_STATS_BUCKETS), "PLANNER_STATS_BUCKETS must divide BLOCK_BUFFER_SIZE");
+
+// Planner queue statistics, updated by the stepper interrupt.
+typedef struct {
+  // Histogram of moves_planned() whenever the stepper takes a new block,
+  // each bucket covers BLOCK_BUFFER_SIZE/PLANNER_STATS_BUCKETS queue levels.
+  uint32_t queue_hist[PLANNER_STATS_BUCKETS];
+  // Number of times the stepper ran out of blocks while printing, split by
+  // the source of the print. Drains are not counted while the main loop waits on purpose.
+  uint16_t starved_sd;
+  uint16_t starved_usb;
+} planner_stats_t;
+
+extern planner_stats_t planner_stats;
+// Set while st_synchronize() or the M109/M190 heater waits keep the main loop from feeding the queue.
+extern volatile bool planner_stats_waiting;
+
+extern void planner_stats_reset();
+extern void planner_stats_report();
+#endif /* PLANNER_STATS */
+
 extern void planner_add_sd_length(uint16_t sdlen);
 
 extern uint16_t planner_calc_sd_length();
@@ -18,3 +18,17 @@ enum PrintType : uint8_t {
 void uvlo_();
 void recover_print(uint8_t automatic);
 void setup_uvlo_interrupt();
+
+/// Request the print settings and the mesh to be copied into the power panic record.
+/// Call whenever they change during a print (print start, M201-M205, M900, G80).
+void uvlo_stage_print_settings();
+
+/// Copy the next part of the staged power panic record to EEPROM, without blocking.
+/// Called periodically from manage_inactivity().
+void uvlo_stage_update();
+
+/// Copy a power panic record saved in XFLASH into EEPROM. Call on boot, before the recovery.
+void uvlo_record_restore();
+
+/// Pre-erase the XFLASH slot for the next power panic record. Call on boot, after the recovery.
+void uvlo_record_prepare();
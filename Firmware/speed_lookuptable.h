@@ -1,10 +1,39 @@
 #ifndef SPEED_LOOKUPTABLE_H
 #define SPEED_LOOKUPTABLE_H
 
-#include "Marlin.h"
+#include <stdint.h>
+#include <avr/pgmspace.h>
+#include "macros.h"
+#include "Configuration_adv.h"
 
-extern const uint16_t speed_lookuptable_fast[256][2] PROGMEM;
-extern const uint16_t speed_lookuptable_slow[256][2] PROGMEM;
+/// Timer1 runs at F_CPU/8 (see st_init()), the lowest representable step rate is F_CPU/500000.
+#define SPEED_LOOKUPTABLE_TIMER_FREQ (F_CPU / 8)
+#define SPEED_LOOKUPTABLE_MIN_RATE (F_CPU / 500000)
+
+/// Step rate to timer interval table. Each entry holds the timer interval at the
+/// start of the segment and the difference to the next segment, used as the
+/// interpolation gain. The fast table has segments of 256 steps/s, the slow one of 8 steps/s.
+struct speed_lookuptable_t {
+    uint16_t e[256][2];
+};
+
+/// Generate the table at compile time. This replaces the output of the former
+/// create_speed_lookuptable.py script and yields bit-identical values, while
+/// automatically following F_CPU.
+/// @param step segment width in steps/s
+constexpr speed_lookuptable_t speed_lookuptable_generate(uint16_t step) {
+    speed_lookuptable_t t {};
+    for (uint16_t i = 0; i < 256; ++i) {
+        const uint16_t a = SPEED_LOOKUPTABLE_TIMER_FREQ / ((uint32_t)i * step + SPEED_LOOKUPTABLE_MIN_RATE);
+        t.e[i][0] = a;
+        if (i) t.e[i - 1][1] = t.e[i - 1][0] - a;
+    }
+    t.e[255][1] = t.e[254][1];
+    return t;
+}
+
+extern const speed_lookuptable_t speed_lookuptable_fast PROGMEM;
+extern const speed_lookuptable_t speed_lookuptable_slow PROGMEM;
 
 #ifndef _NO_ASM
 
@@ -108,35 +137,34 @@ FORCE_INLINE uint16_t MUL24x24R24(uint32_t longIn1, uint32_t longIn2)
 #endif //_NO_ASM
 
 
-FORCE_INLINE unsigned short calc_timer(uint16_t step_rate, uint8_t& step_loops) {
+/// Convert a step rate to a timer interval.
+/// @param step_rate steps/s, clamped to MAX_STEP_FREQUENCY
+/// @param step_loops set to the number of steps to be executed per interrupt (1, 2 or 4)
+/// @return OCR1A interval in timer ticks
+///
+/// Above 10kHz/20kHz the rate is divided and the steps are grouped. The grouping is
+/// computed from two comparisons instead of a branch chain so that the accelerating
+/// and decelerating ticks of the stepper isr take a constant path up to the table lookup.
+FORCE_INLINE uint16_t calc_timer(uint16_t step_rate, uint8_t& step_loops) {
   uint16_t timer;
   if(step_rate > MAX_STEP_FREQUENCY) step_rate = MAX_STEP_FREQUENCY;
 
-  if(step_rate > 20000) { // If steprate > 20kHz >> step 4 times
-    step_rate = (step_rate >> 2)&0x3fff;
-    step_loops = 4;
-  }
-  else if(step_rate > 10000) { // If steprate > 10kHz >> step 2 times
-    step_rate = (step_rate >> 1)&0x7fff;
-    step_loops = 2;
-  }
-  else {
-    step_loops = 1;
-  }
+  // 0, 1 or 2: how many times the rate is halved (step 1, 2 or 4 times per interrupt)
+  const uint8_t shift = (step_rate > 10000) + (step_rate > 20000);
+  step_loops = 1 << shift;
+  step_rate >>= shift;
 
-  if(step_rate < (F_CPU/500000)) step_rate = (F_CPU/500000);
-  step_rate -= (F_CPU/500000); // Correct for minimal speed
+  if(step_rate < SPEED_LOOKUPTABLE_MIN_RATE) step_rate = SPEED_LOOKUPTABLE_MIN_RATE;
+  step_rate -= SPEED_LOOKUPTABLE_MIN_RATE; // Correct for minimal speed
   if(step_rate >= (8*256)){ // higher step rate
-    unsigned short table_address = (unsigned short)&speed_lookuptable_fast[(unsigned char)(step_rate>>8)][0];
-    unsigned char tmp_step_rate = (step_rate & 0x00ff);
-    uint16_t gain = (uint16_t)pgm_read_word_near(table_address+2);
-    timer = (unsigned short)pgm_read_word_near(table_address) - MUL8x16R8(tmp_step_rate, gain);
+    const uint16_t* table_address = speed_lookuptable_fast.e[(uint8_t)(step_rate >> 8)];
+    uint16_t gain = pgm_read_word_near(table_address + 1);
+    timer = pgm_read_word_near(table_address) - MUL8x16R8((uint8_t)step_rate, gain);
   }
   else { // lower step rates
-    unsigned short table_address = (unsigned short)&speed_lookuptable_slow[0][0];
-    table_address += ((step_rate)>>1) & 0xfffc;
-    timer = (unsigned short)pgm_read_word_near(table_address);
-    timer -= (((unsigned short)pgm_read_word_near(table_address+2) * (unsigned char)(step_rate & 0x0007))>>3);
+    const uint16_t* table_address = speed_lookuptable_slow.e[step_rate >> 3];
+    timer = pgm_read_word_near(table_address);
+    timer -= ((pgm_read_word_near(table_address + 1) * (uint8_t)(step_rate & 0x0007)) >> 3);
   }
   if(timer < 100) { timer = 100; }//(20kHz this should never happen)////MSG_STEPPER_TOO_HIGH c=0 r=0
   return timer;
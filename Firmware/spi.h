@@ -42,6 +42,40 @@ static inline uint8_t spi_txrx(uint8_t tx)
 	return SPDR;
 }
 
+// Block transfers shared by the SD card and XFLASH drivers, the TMC2130 datagrams are too short for them.
+// The next byte is loaded into SPDR right after the previous one is done, so
+// the loop overhead and the memory access overlap with the shifting.
+
+/// Receive cnt bytes into buf, sending 0xff
+static inline void spi_rx_block(uint8_t* buf, uint16_t cnt)
+{
+	if (cnt-- == 0) return;
+	SPDR = 0xff;
+	while (cnt--)
+	{
+		while (!(SPSR & (1 << SPIF)));
+		uint8_t b = SPDR;
+		SPDR = 0xff;
+		*(buf++) = b;
+	}
+	while (!(SPSR & (1 << SPIF)));
+	*buf = SPDR;
+}
+
+/// Send cnt bytes from buf, the received bytes are discarded
+static inline void spi_tx_block(const uint8_t* buf, uint16_t cnt)
+{
+	if (cnt == 0) return;
+	SPDR = *(buf++);
+	while (--cnt)
+	{
+		uint8_t b = *(buf++);
+		while (!(SPSR & (1 << SPIF)));
+		SPDR = b;
+	}
+	while (!(SPSR & (1 << SPIF)));
+}
+
 #if defined(__cplusplus)
 }
 #endif //defined(__cplusplus)
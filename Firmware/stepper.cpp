@@ -39,6 +39,7 @@
 #include "Filament_sensor.h"
 #include "ConfigurationStore.h"
 #include "Prusa_farm.h"
+#include "loop_stats.h"
 
 #ifdef DEBUG_STACK_MONITOR
 uint16_t SP_min = 0x21FF;
@@ -117,7 +118,6 @@ volatile dda_usteps_t step_events_completed; // The number of step events execut
 static uint32_t  acceleration_time, deceleration_time;
 static uint16_t acc_step_rate; // needed for deccelaration start point
 static uint8_t  step_loops;
-static uint16_t OCR1A_nominal;
 static uint8_t  step_loops_nominal;
 
 #ifdef VERBOSE_CHECK_HIT_ENDSTOPS
@@ -178,6 +178,14 @@ extern bool stepper_timer_overflow_state;
 extern uint16_t stepper_timer_overflow_last;
 #endif /* DEBUG_STEPPER_TIMER_MISSED */
 
+#ifdef PLANNER_STATS
+static bool queue_active; // a block has been executed since the queue was last found empty
+#endif //PLANNER_STATS
+
+#ifdef STEPPER_ISR_STATS
+static stepper_isr_stats_t isr_stats = { 0, 0, 0, UINT16_MAX, 0, 0, 0, {} };
+#endif //STEPPER_ISR_STATS
+
 //===========================================================================
 //=============================functions         ============================
 //===========================================================================
@@ -280,28 +288,70 @@ ISR(TIMER1_COMPA_vect) {
     isr();
 #endif
 
+#ifdef STEPPER_ISR_STATS
+  {
+    // TIMER1 runs in CTC mode and has been cleared by the compare match which triggered
+    // this interrupt: TCNT1 is the time spent since then, including the entry latency.
+    uint16_t ticks = TCNT1;
+    if (isr_stats.count != UINT32_MAX) {
+      ++isr_stats.count;
+      if ((isr_stats.sum += ticks) < ticks) ++isr_stats.sum_hi;
+      if (ticks < isr_stats.min) isr_stats.min = ticks;
+      if (ticks > isr_stats.max) isr_stats.max = ticks;
+      uint16_t bucket = ticks >> STEPPER_ISR_STATS_BUCKET_SHIFT;
+      if (bucket >= STEPPER_ISR_STATS_BUCKETS) bucket = STEPPER_ISR_STATS_BUCKETS - 1;
+      ++isr_stats.hist[bucket];
+    }
+  }
+#endif //STEPPER_ISR_STATS
+
   // Don't run the ISR faster than possible
   // Is there a 8us time left before the next interrupt triggers?
   if (OCR1A < TCNT1 + 16) {
-#ifdef DEBUG_STEPPER_TIMER_MISSED
+#if defined(DEBUG_STEPPER_TIMER_MISSED) || defined(STEPPER_ISR_STATS)
     // Verify whether the next planned timer interrupt has not been missed already.
     // This debugging test takes < 1.125us
     // This skews the profiling slightly as the fastest stepper timer
     // interrupt repeats at a 100us rate (10kHz).
     if (OCR1A + 40 < TCNT1) {
       // The interrupt was delayed by more than 20us (which is 1/5th of the 10kHz ISR repeat rate).
+#ifdef STEPPER_ISR_STATS
+      ++isr_stats.missed;
+#endif //STEPPER_ISR_STATS
+#ifdef DEBUG_STEPPER_TIMER_MISSED
       // Give a warning.
       stepper_timer_overflow_state = true;
       stepper_timer_overflow_last = TCNT1 - OCR1A;
       // Beep, the beeper will be cleared at the stepper_timer_overflow() called from the main thread.
       WRITE(BEEPER, HIGH);
+#endif //DEBUG_STEPPER_TIMER_MISSED
     }
 #endif
+#ifdef STEPPER_ISR_STATS
+    ++isr_stats.clamped;
+#endif //STEPPER_ISR_STATS
     // Fix the next interrupt to be executed after 8us from now.
     OCR1A = TCNT1 + 16;
   }
 }
 
+#ifdef STEPPER_ISR_STATS
+void st_isr_stats_reset()
+{
+  CRITICAL_SECTION_START;
+  memset(&isr_stats, 0, sizeof(isr_stats));
+  isr_stats.min = UINT16_MAX;
+  CRITICAL_SECTION_END;
+}
+
+void st_isr_stats_get(stepper_isr_stats_t &stats)
+{
+  CRITICAL_SECTION_START;
+  stats = isr_stats;
+  CRITICAL_SECTION_END;
+}
+#endif //STEPPER_ISR_STATS
+
 uint8_t last_dir_bits = 0;
 
 #ifdef BACKLASH_X
@@ -317,6 +367,10 @@ FORCE_INLINE void stepper_next_block()
   //WRITE_NC(LOGIC_ANALYZER_CH2, true);
   current_block = plan_get_current_block();
   if (current_block != NULL) {
+#ifdef PLANNER_STATS
+    ++planner_stats.queue_hist[moves_planned() / (BLOCK_BUFFER_SIZE / PLANNER_STATS_BUCKETS)];
+    queue_active = true;
+#endif //PLANNER_STATS
 #ifdef BACKLASH_X
 	if (current_block->steps[X_AXIS].wide)
 	{ //X-axis movement
@@ -369,9 +423,7 @@ FORCE_INLINE void stepper_next_block()
     // Initializes the trapezoid generator from the current block. Called whenever a new
     // block begins.
     deceleration_time = 0;
-    // Set the nominal step loops to zero to indicate, that the timer value is not known yet.
-    // That means, delay the initialization of nominal step rate and step loops until the steady
-    // state is reached.
+    // Set the nominal step loops to zero to indicate, that the steady state has not been reached yet.
     step_loops_nominal = 0;
     acc_step_rate = uint16_t(current_block->initial_rate);
     acceleration_time = calc_timer(acc_step_rate, step_loops);
@@ -448,6 +500,20 @@ FORCE_INLINE void stepper_next_block()
   else {
       _NEXT_ISR(2000); // 1kHz.
 
+#ifdef PLANNER_STATS
+      if (queue_active) {
+          // The queue just ran dry: count it if a print is running,
+          // unless the G-code asked for it by waiting for the moves or a heater.
+          queue_active = false;
+          if (!planner_stats_waiting) {
+              if (IS_SD_PRINTING)
+                  ++planner_stats.starved_sd;
+              else if (usb_timer.running())
+                  ++planner_stats.starved_usb;
+          }
+      }
+#endif //PLANNER_STATS
+
 #ifdef LIN_ADVANCE
       // reset LA state when there's no block
       nextAdvanceISR = ADV_NEVER;
@@ -881,10 +947,9 @@ FORCE_INLINE void isr() {
       }
       else {
         if (! step_loops_nominal) {
-          // Calculation of the steady state timer rate has been delayed to the 1st tick of the steady state to lower
-          // the initial interrupt blocking.
-          OCR1A_nominal = calc_timer(uint16_t(current_block->nominal_rate), step_loops);
-          step_loops_nominal = step_loops;
+          // The steady state timer rate has been precomputed by the planner, switch to it
+          // at the 1st tick of the steady state.
+          step_loops = step_loops_nominal = current_block->nominal_step_loops;
 
 #ifdef LIN_ADVANCE
           if(current_block->use_advance_lead) {
@@ -897,7 +962,7 @@ FORCE_INLINE void isr() {
           }
 #endif
         }
-        _NEXT_ISR(OCR1A_nominal);
+        _NEXT_ISR(current_block->nominal_timer);
       }
       //WRITE_NC(LOGIC_ANALYZER_CH1, false);
     }
@@ -949,6 +1014,12 @@ FORCE_INLINE void isr() {
     if (step_events_completed.wide >= current_block->step_event_count.wide) {
       current_block = NULL;
       plan_discard_current_block();
+#ifdef PLANNER_STATS
+      // The waiter leaves its loop and clears the flag as soon as the queue is empty,
+      // decide about a drain it asked for before the next tick finds the queue empty.
+      if (planner_stats_waiting && !blocks_queued())
+        queue_active = false;
+#endif //PLANNER_STATS
     }
   }
 
@@ -1040,14 +1111,14 @@ FORCE_INLINE void advance_isr_scheduler() {
         uint8_t max_ticks = (eisr? e_step_loops: step_loops);
         max_ticks = min(abs(e_steps), max_ticks);
         bool rev = (e_steps < 0);
+#if defined(FILAMENT_SENSOR) && (FILAMENT_SENSOR_TYPE == FSENSOR_PAT9125)
+        fsensor.stSteps(rev ? -(int8_t)max_ticks : (int8_t)max_ticks);
+#endif //defined(FILAMENT_SENSOR) && (FILAMENT_SENSOR_TYPE == FSENSOR_PAT9125)
         do
         {
             STEP_NC_HI(E_AXIS);
             e_steps += (rev? 1: -1);
             STEP_NC_LO(E_AXIS);
-#if defined(FILAMENT_SENSOR) && (FILAMENT_SENSOR_TYPE == FSENSOR_PAT9125)
-            fsensor.stStep(rev);
-#endif //defined(FILAMENT_SENSOR) && (FILAMENT_SENSOR_TYPE == FSENSOR_PAT9125)
         }
         while(--max_ticks);
     }
@@ -1238,8 +1309,7 @@ void st_init()
   // Set the timer pre-scaler
   // Generally we use a divider of 8, resulting in a 2MHz timer
   // frequency on a 16MHz MCU. If you are going to change this, be
-  // sure to regenerate speed_lookuptable.h with
-  // create_speed_lookuptable.py
+  // sure to update SPEED_LOOKUPTABLE_TIMER_FREQ in speed_lookuptable.h
   TCCR1B = (TCCR1B & ~(0x07<<CS10)) | (2<<CS10);
 
   // Plan the first interrupt after 8ms from now.
@@ -1288,6 +1358,12 @@ void st_reset_timer()
 // Block until all buffered steps are executed
 void st_synchronize()
 {
+#ifdef LOOP_STATS
+	const uint32_t start_us = _micros();
+#endif //LOOP_STATS
+#ifdef PLANNER_STATS
+	planner_stats_waiting = true;
+#endif //PLANNER_STATS
 	while(blocks_queued())
 	{
 #ifdef TMC2130
@@ -1303,6 +1379,12 @@ void st_synchronize()
 		delay_keep_alive(0);
 #endif //TMC2130
 	}
+#ifdef PLANNER_STATS
+	planner_stats_waiting = false;
+#endif //PLANNER_STATS
+#ifdef LOOP_STATS
+	loop_stats_blocking(BlockingCall::st_synchronize, start_us);
+#endif //LOOP_STATS
 }
 
 void st_set_position(const long *pos)
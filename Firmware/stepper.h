@@ -69,6 +69,26 @@ void invert_z_endstop(bool endstop_invert);
 
 void checkStepperErrors(); //Print errors detected by the stepper
 
+#ifdef STEPPER_ISR_STATS
+#define STEPPER_ISR_STATS_BUCKETS 8      // number of histogram buckets
+#define STEPPER_ISR_STATS_BUCKET_SHIFT 4 // histogram bucket width: 16 ticks (8us)
+
+// Timing statistics of the stepper interrupt, in TIMER1 ticks (0.5us)
+typedef struct {
+  uint32_t count;   // number of interrupts executed, the statistics stop once it saturates
+  uint32_t sum;     // total ticks spent, for the average
+  uint16_t sum_hi;  // carry of sum, 48 bits cannot overflow before count saturates
+  uint16_t min;
+  uint16_t max;
+  uint32_t clamped; // next interrupt postponed to the 8us minimum
+  uint32_t missed;  // next interrupt deadline missed by more than 20us
+  uint32_t hist[STEPPER_ISR_STATS_BUCKETS];
+} stepper_isr_stats_t;
+
+void st_isr_stats_reset();
+void st_isr_stats_get(stepper_isr_stats_t &stats); // atomic copy of the current statistics
+#endif //STEPPER_ISR_STATS
+
 extern block_t *current_block;  // A pointer to the block currently being traced
 extern volatile long count_position[NUM_AXIS];
 
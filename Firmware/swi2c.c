@@ -18,7 +18,7 @@
 static void __delay(void);
 static void swi2c_start(void);
 static void swi2c_stop(void);
-// static void swi2c_ack(void);
+static void swi2c_ack(void);
 static void swi2c_nack(void);
 static uint8_t swi2c_wait_ack();
 static uint8_t swi2c_read(void);
@@ -73,7 +73,6 @@ static void swi2c_stop(void)
 	__delay();
 }
 
-/*
 static void swi2c_ack(void)
 {
 	WRITE(SWI2C_SDA, 0);
@@ -83,7 +82,6 @@ static void swi2c_ack(void)
 	WRITE(SWI2C_SCL, 0);
 	__delay();
 }
-*/
 
 static void swi2c_nack(void)
 {
@@ -174,6 +172,26 @@ uint8_t swi2c_readByte_A8(uint8_t dev_addr, uint8_t addr, uint8_t* pbyte)
 	return 1;
 }
 
+uint8_t swi2c_readBlock_A8(uint8_t dev_addr, uint8_t addr, uint8_t* pbytes, uint8_t cnt)
+{
+	swi2c_start();
+	swi2c_write(SWI2C_WMSK | ((dev_addr & SWI2C_DMSK) << SWI2C_ASHF));
+	if (!swi2c_wait_ack()) { swi2c_stop(); return 0; }
+	swi2c_write(addr & 0xff);
+	if (!swi2c_wait_ack()) return 0;
+	swi2c_stop();
+	swi2c_start();
+	swi2c_write(SWI2C_RMSK | ((dev_addr & SWI2C_DMSK) << SWI2C_ASHF));
+	if (!swi2c_wait_ack()) return 0;
+	while (cnt--)
+	{
+		*(pbytes++) = swi2c_read();
+		if (cnt) swi2c_ack(); //the last byte is not acknowledged, same as in swi2c_readByte_A8
+	}
+	swi2c_stop();
+	return 1;
+}
+
 uint8_t swi2c_writeByte_A8(uint8_t dev_addr, uint8_t addr, uint8_t* pbyte)
 {
 	swi2c_start();
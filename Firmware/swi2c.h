@@ -23,6 +23,8 @@ extern uint8_t swi2c_check(uint8_t dev_addr);
 #ifdef SWI2C_A8
 extern uint8_t swi2c_readByte_A8(uint8_t dev_addr, uint8_t addr, uint8_t* pbyte);
 extern uint8_t swi2c_writeByte_A8(uint8_t dev_addr, uint8_t addr, uint8_t* pbyte);
+//sequential read of cnt bytes starting at addr in a single transaction (device must auto-increment the address)
+extern uint8_t swi2c_readBlock_A8(uint8_t dev_addr, uint8_t addr, uint8_t* pbytes, uint8_t cnt);
 #endif //SWI2C_A8
 
 //read write functions - 16bit address (e.g. serial eeprom AT24C256)
@@ -275,6 +275,12 @@ uint32_t tmc2130_rd_MSCURACT(uint8_t axis);
 
 static void tmc2130_tx(uint8_t axis, uint8_t addr, uint32_t wval);
 static uint8_t tmc2130_rx(uint8_t axis, uint8_t addr, uint32_t* rval);
+static uint8_t tmc2130_rx_next(uint8_t axis, uint8_t addr, uint8_t next_addr, uint32_t* rval);
+
+/// Register whose value each driver returns in the next datagram, 0xff if unknown.
+/// Every datagram latches the register addressed by it, so a read request can share
+/// the datagram with the response to the previous one.
+static uint8_t tmc2130_rx_addr[4] = {0xff, 0xff, 0xff, 0xff};
 
 uint16_t __tcoolthrs(uint8_t axis)
 {
@@ -406,7 +412,8 @@ bool tmc2130_update_sg()
 	if (tmc2130_sg_measure <= E_AXIS)
 	{
 		uint32_t val32 = 0;
-		tmc2130_rd(tmc2130_sg_measure, TMC2130_REG_DRV_STATUS, &val32);
+		// latched by the previous call, tmc2130_sg_measure_start() makes the first one fresh
+		tmc2130_rx_next(tmc2130_sg_measure, TMC2130_REG_DRV_STATUS, TMC2130_REG_DRV_STATUS, &val32);
 		tmc2130_sg_measure_val += (val32 & 0x3ff);
 		tmc2130_sg_measure_cnt++;
 		return true;
@@ -462,6 +469,7 @@ void tmc2130_sg_measure_start(uint8_t axis)
 	tmc2130_sg_measure = axis;
 	tmc2130_sg_measure_cnt = 0;
 	tmc2130_sg_measure_val = 0;
+	tmc2130_rx_addr[axis] = 0xff; // do not average in a DRV_STATUS latched before the measurement
 }
 
 uint16_t tmc2130_sg_measure_stop()
@@ -475,12 +483,16 @@ bool tmc2130_wait_standstill_xy(int timeout)
 {
 //	DBG(_n("tmc2130_wait_standstill_xy(timeout=%d)\n"), timeout);
 	bool standstill = false;
+	// a DRV_STATUS latched before the wait may report a standstill of the previous move
+	tmc2130_rx_addr[X_AXIS] = 0xff;
+	tmc2130_rx_addr[Y_AXIS] = 0xff;
 	while (!standstill && (timeout > 0))
 	{
 		uint32_t drv_status_x = 0;
 		uint32_t drv_status_y = 0;
-		tmc2130_rd(X_AXIS, TMC2130_REG_DRV_STATUS, &drv_status_x);
-		tmc2130_rd(Y_AXIS, TMC2130_REG_DRV_STATUS, &drv_status_y);
+		// latched by the previous iteration
+		tmc2130_rx_next(X_AXIS, TMC2130_REG_DRV_STATUS, TMC2130_REG_DRV_STATUS, &drv_status_x);
+		tmc2130_rx_next(Y_AXIS, TMC2130_REG_DRV_STATUS, TMC2130_REG_DRV_STATUS, &drv_status_y);
 //		DBG(_n("\tdrv_status_x=0x%08x drv_status_x=0x%08x\n"), drv_status_x, drv_status_y);
 		standstill = (drv_status_x & 0x80000000) && (drv_status_y & 0x80000000);
 		tmc2130_check_overtemp();
@@ -493,10 +505,11 @@ void tmc2130_check_overtemp()
 {
 	if (tmc2130_overtemp_timer.expired_cont(1000))
 	{
+		uint32_t drv_status_all[4];
+		tmc2130_rd_DRV_STATUS_all(drv_status_all);
 		for (uint_least8_t i = 0; i < 4; i++)
 		{
-			uint32_t drv_status = 0;
-			tmc2130_rd(i, TMC2130_REG_DRV_STATUS, &drv_status);
+			const uint32_t drv_status = drv_status_all[i];
 			if (drv_status & ((uint32_t)1 << 26))
 			{ // BIT 26 - over temp prewarning ~120C (+-20C)
 				SERIAL_ERRORRPGM(MSG_TMC_OVERTEMP);
@@ -688,6 +701,7 @@ inline void tmc2130_cs_high(uint8_t axis)
 
 static void tmc2130_tx(uint8_t axis, uint8_t addr, uint32_t wval)
 {
+	tmc2130_rx_addr[axis] = 0xff;
 	//datagram1 - request
 	TMC2130_SPI_ENTER();
 	tmc2130_cs_low(axis);
@@ -700,22 +714,28 @@ static void tmc2130_tx(uint8_t axis, uint8_t addr, uint32_t wval)
 	TMC2130_SPI_LEAVE();
 }
 
-static uint8_t tmc2130_rx(uint8_t axis, uint8_t addr, uint32_t* rval)
+/// Reads @addr and requests @next_addr in the same datagram.
+/// The request datagram is skipped if @addr was already requested by the previous access,
+/// the value is latched at the time of that access then.
+static uint8_t tmc2130_rx_next(uint8_t axis, uint8_t addr, uint8_t next_addr, uint32_t* rval)
 {
-	//datagram1 - request
-	TMC2130_SPI_ENTER();
-	tmc2130_cs_low(axis);
-	TMC2130_SPI_TXRX(addr); // address
-	TMC2130_SPI_TXRX(0); // MSB
-	TMC2130_SPI_TXRX(0);
-	TMC2130_SPI_TXRX(0);
-	TMC2130_SPI_TXRX(0); // LSB
-	tmc2130_cs_high(axis);
-	TMC2130_SPI_LEAVE();
-	//datagram2 - response
+	if (tmc2130_rx_addr[axis] != addr)
+	{
+		//datagram1 - request
+		TMC2130_SPI_ENTER();
+		tmc2130_cs_low(axis);
+		TMC2130_SPI_TXRX(addr); // address
+		TMC2130_SPI_TXRX(0); // MSB
+		TMC2130_SPI_TXRX(0);
+		TMC2130_SPI_TXRX(0);
+		TMC2130_SPI_TXRX(0); // LSB
+		tmc2130_cs_high(axis);
+		TMC2130_SPI_LEAVE();
+	}
+	//datagram2 - response and next request
 	TMC2130_SPI_ENTER();
 	tmc2130_cs_low(axis);
-	uint8_t stat = TMC2130_SPI_TXRX(0); // status
+	uint8_t stat = TMC2130_SPI_TXRX(next_addr); // status
 	uint32_t val32 = 0;
 	val32 = TMC2130_SPI_TXRX(0); // MSB
 	val32 = (val32 << 8) | TMC2130_SPI_TXRX(0);
@@ -723,10 +743,24 @@ static uint8_t tmc2130_rx(uint8_t axis, uint8_t addr, uint32_t* rval)
 	val32 = (val32 << 8) | TMC2130_SPI_TXRX(0); // LSB
 	tmc2130_cs_high(axis);
 	TMC2130_SPI_LEAVE();
+	tmc2130_rx_addr[axis] = next_addr;
 	if (rval != 0) *rval = val32;
 	return stat;
 }
 
+static uint8_t tmc2130_rx(uint8_t axis, uint8_t addr, uint32_t* rval)
+{
+	// always request the current value
+	tmc2130_rx_addr[axis] = 0xff;
+	return tmc2130_rx_next(axis, addr, 0, rval);
+}
+
+void tmc2130_rd_DRV_STATUS_all(uint32_t* drv_status)
+{
+	for (uint8_t axis = X_AXIS; axis <= E_AXIS; axis++)
+		tmc2130_rx_next(axis, TMC2130_REG_DRV_STATUS, TMC2130_REG_DRV_STATUS, drv_status + axis);
+}
+
 uint16_t tmc2130_get_res(uint8_t axis)
 {
 	return tmc2130_mres2usteps(tmc2130_mres[axis]);
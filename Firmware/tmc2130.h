@@ -158,6 +158,10 @@ extern void tmc2130_st_isr();
 extern bool tmc2130_update_sg();
 //temperature watching (called from )
 extern void tmc2130_check_overtemp();
+
+//read DRV_STATUS of all drivers and request it again, so the next call needs a single datagram per driver
+//the values are latched by the previous call then, unless another register was accessed in between
+extern void tmc2130_rd_DRV_STATUS_all(uint32_t* drv_status);
 //enter homing (called from homeaxis before homing starts)
 extern void tmc2130_home_enter(uint8_t axes_mask);
 //exit homing (called from homeaxis after homing ends)
@@ -1160,8 +1160,8 @@ static void lcd_menu_fails_stats_mmu_print() {
              " %-16.16S%-3d"
         ),
         _T(MSG_LAST_PRINT_FAILURES),
-        _T(MSG_MMU_FAILS), clamp999( eeprom_read_byte((uint8_t*)EEPROM_MMU_FAIL) ),
-        _T(MSG_MMU_LOAD_FAILS), clamp999( eeprom_read_byte((uint8_t*)EEPROM_MMU_LOAD_FAIL) ));
+        _T(MSG_MMU_FAILS), clamp999( eeprom_cache_read_byte((uint8_t*)EEPROM_MMU_FAIL) ),
+        _T(MSG_MMU_LOAD_FAILS), clamp999( eeprom_cache_read_byte((uint8_t*)EEPROM_MMU_LOAD_FAIL) ));
     menu_back_if_clicked();
 }
 
@@ -1185,8 +1185,8 @@ static void lcd_menu_fails_stats_mmu_total() {
              " %-16.16S%-3d"
         ),
         _T(MSG_TOTAL_FAILURES),
-        _T(MSG_MMU_FAILS), clamp999( eeprom_read_word((uint16_t*)EEPROM_MMU_FAIL_TOT) ),
-        _T(MSG_MMU_LOAD_FAILS), clamp999( eeprom_read_word((uint16_t*)EEPROM_MMU_LOAD_FAIL_TOT) ),
+        _T(MSG_MMU_FAILS), clamp999( eeprom_cache_read_word((uint16_t*)EEPROM_MMU_FAIL_TOT) ),
+        _T(MSG_MMU_LOAD_FAILS), clamp999( eeprom_cache_read_word((uint16_t*)EEPROM_MMU_LOAD_FAIL_TOT) ),
         _T(MSG_MMU_POWER_FAILS), clamp999( MMU2::mmu2.TMCFailures() ));
     menu_back_if_clicked();
 }
@@ -1214,7 +1214,7 @@ static void lcd_menu_toolchange_stats_mmu_total()
         lcd_puts_P(_T(MSG_MATERIAL_CHANGES)); /// MSG_MATERIAL_CHANGES c=18
         lcd_putc(':');
         lcd_set_cursor(10, 1);
-        lcd_print(eeprom_read_dword((uint32_t*)EEPROM_MMU_MATERIAL_CHANGES));
+        lcd_print(eeprom_cache_read_dword((uint32_t*)EEPROM_MMU_MATERIAL_CHANGES));
         _md->initialized = true;
     }
     menu_back_if_clicked();
@@ -1239,11 +1239,11 @@ static void lcd_menu_fails_stats_total()
 	lcd_home();
     lcd_printf_P(failStatsFmt,
         _T(MSG_TOTAL_FAILURES),
-        _T(MSG_POWER_FAILURES), clamp999( eeprom_read_word((uint16_t*)EEPROM_POWER_COUNT_TOT) ),
-        _T(MSG_FIL_RUNOUTS), clamp999( eeprom_read_word((uint16_t*)EEPROM_FERROR_COUNT_TOT) ),
+        _T(MSG_POWER_FAILURES), clamp999( eeprom_cache_read_word((uint16_t*)EEPROM_POWER_COUNT_TOT) ),
+        _T(MSG_FIL_RUNOUTS), clamp999( eeprom_cache_read_word((uint16_t*)EEPROM_FERROR_COUNT_TOT) ),
         _T(MSG_CRASH),
-            clamp999( eeprom_read_word((uint16_t*)EEPROM_CRASH_COUNT_X_TOT) ),
-            clamp999( eeprom_read_word((uint16_t*)EEPROM_CRASH_COUNT_Y_TOT) ));
+            clamp999( eeprom_cache_read_word((uint16_t*)EEPROM_CRASH_COUNT_X_TOT) ),
+            clamp999( eeprom_cache_read_word((uint16_t*)EEPROM_CRASH_COUNT_Y_TOT) ));
     menu_back_if_clicked();
 }
 
@@ -1261,10 +1261,10 @@ static void lcd_menu_fails_stats_total()
 static void lcd_menu_fails_stats_print()
 {
 	lcd_timeoutToStatus.stop(); //infinite timeout
-    uint8_t power = eeprom_read_byte((uint8_t*)EEPROM_POWER_COUNT);
-    uint8_t filam = eeprom_read_byte((uint8_t*)EEPROM_FERROR_COUNT);
-    uint8_t crashX = eeprom_read_byte((uint8_t*)EEPROM_CRASH_COUNT_X);
-    uint8_t crashY = eeprom_read_byte((uint8_t*)EEPROM_CRASH_COUNT_Y);
+    uint8_t power = eeprom_cache_read_byte((uint8_t*)EEPROM_POWER_COUNT);
+    uint8_t filam = eeprom_cache_read_byte((uint8_t*)EEPROM_FERROR_COUNT);
+    uint8_t crashX = eeprom_cache_read_byte((uint8_t*)EEPROM_CRASH_COUNT_X);
+    uint8_t crashY = eeprom_cache_read_byte((uint8_t*)EEPROM_CRASH_COUNT_Y);
     lcd_home();
     lcd_printf_P(failStatsFmt,
         _T(MSG_LAST_PRINT_FAILURES),
@@ -1318,8 +1318,8 @@ static const char failStatsFmt[] PROGMEM = "%S\n" " %-16.16S%-3d\n" "%S\n" " %-1
 static void lcd_menu_fails_stats()
 {
 	lcd_timeoutToStatus.stop(); //infinite timeout
-    uint8_t filamentLast = eeprom_read_byte((uint8_t*)EEPROM_FERROR_COUNT);
-    uint16_t filamentTotal = clamp999( eeprom_read_word((uint16_t*)EEPROM_FERROR_COUNT_TOT) );
+    uint8_t filamentLast = eeprom_cache_read_byte((uint8_t*)EEPROM_FERROR_COUNT);
+    uint16_t filamentTotal = clamp999( eeprom_cache_read_word((uint16_t*)EEPROM_FERROR_COUNT_TOT) );
 	lcd_home();
 	lcd_printf_P(failStatsFmt,
         _T(MSG_LAST_PRINT_FAILURES),
@@ -2410,8 +2410,8 @@ void lcd_menu_statistics()
 	}
 	else
 	{
-		uint32_t _filament = eeprom_read_dword((uint32_t *)EEPROM_FILAMENTUSED); // in meters
-		uint32_t _time = eeprom_read_dword((uint32_t *)EEPROM_TOTALTIME); // in minutes
+		uint32_t _filament = eeprom_cache_read_dword((uint32_t *)EEPROM_FILAMENTUSED); // in meters
+		uint32_t _time = eeprom_cache_read_dword((uint32_t *)EEPROM_TOTALTIME); // in minutes
 		uint8_t _hours, _minutes;
 		uint32_t _days;
 		float _filament_m = (float)_filament/100;
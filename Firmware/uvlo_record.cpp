@@ -0,0 +1,85 @@
+/// @file
+#include <stddef.h>
+#include "uvlo_record.h"
+
+#ifdef __AVR__
+    #include <util/crc16.h>
+#endif
+
+static uint16_t uvlo_record_crc(const uvlo_record_t& rec)
+{
+    const uint8_t* data = (const uint8_t*)&rec;
+    uint16_t crc = 0xFFFF;
+    for (uint8_t i = 0; i < offsetof(uvlo_record_t, crc); ++i)
+    {
+#ifdef __AVR__
+        crc = _crc_ccitt_update(crc, data[i]);
+#else
+        crc ^= data[i];
+        for (uint8_t b = 0; b < 8; ++b)
+            crc = (crc & 1) ? (crc >> 1) ^ 0x8408 : (crc >> 1);
+#endif
+    }
+    return crc;
+}
+
+void uvlo_record_seal(uvlo_record_t& rec, uint16_t seq)
+{
+    rec.magic = UVLO_RECORD_MAGIC;
+    rec.seq = seq;
+    rec.crc = uvlo_record_crc(rec);
+}
+
+bool uvlo_record_valid(const uvlo_record_t& rec)
+{
+    return rec.magic == UVLO_RECORD_MAGIC && rec.crc == uvlo_record_crc(rec);
+}
+
+bool uvlo_record_blank(const uvlo_record_t& rec)
+{
+    const uint8_t* data = (const uint8_t*)&rec;
+    for (uint8_t i = 0; i < sizeof(rec); ++i)
+    {
+        if (data[i] != 0xFF)
+            return false;
+    }
+    return true;
+}
+
+uvlo_record_scan_t uvlo_record_scan(uint32_t base, uvlo_record_rd_t rd, uvlo_record_t& rec)
+{
+    uvlo_record_scan_t scan = { -1, 0, 1 };
+    int8_t newest = -1;
+    uint16_t newest_seq = 0;
+    bool newest_valid = false;
+
+    for (uint8_t slot = 0; slot < UVLO_RECORD_SLOTS; ++slot)
+    {
+        uvlo_record_t tmp;
+        rd(base + slot * UVLO_RECORD_SLOT_SIZE, (uint8_t*)&tmp, sizeof(tmp));
+
+        // Consumed and torn records still hold the sequence number, blank slots don't
+        if (tmp.magic != UVLO_RECORD_MAGIC && tmp.magic != UVLO_RECORD_CONSUMED)
+            continue;
+
+        // Compare the sequence numbers modulo 2^16
+        if (newest < 0 || (int16_t)(tmp.seq - newest_seq) > 0)
+        {
+            newest = slot;
+            newest_seq = tmp.seq;
+            newest_valid = uvlo_record_valid(tmp);
+            if (newest_valid)
+                rec = tmp;
+        }
+    }
+
+    if (newest >= 0)
+    {
+        // An older valid record belongs to a previous power panic and must not be used
+        if (newest_valid)
+            scan.valid_slot = newest;
+        scan.next_slot = (newest + 1) % UVLO_RECORD_SLOTS;
+        scan.next_seq = newest_seq + 1;
+    }
+    return scan;
+}
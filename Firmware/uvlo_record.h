@@ -0,0 +1,61 @@
+/// @file
+/// Compact power panic record, written into a pre-erased XFLASH sector with a single page program.
+#pragma once
+#include <stdint.h>
+
+#define UVLO_RECORD_MAGIC    0x4F4C5655ul // "UVLO"
+#define UVLO_RECORD_CONSUMED 0x00000000ul // magic cleared after the record was restored
+#define UVLO_RECORD_SLOTS     2           // double buffered
+#define UVLO_RECORD_SLOT_SIZE 4096ul      // one erase sector per slot
+
+/// Volatile part of the print state saved on power panic.
+/// The print settings and the mesh are staged into EEPROM ahead of time and are not part of the record.
+typedef struct __attribute__((packed))
+{
+    uint32_t magic;
+    uint16_t seq;                     //!< incremented on every write, newest valid record wins
+    float pos[2];                     //!< X and Y logical position (X_COORD_INVALID if unknown)
+    float pos_z;                      //!< logical Z position without MBL
+    float pos_e;
+    float tiny_z;                     //!< final physical Z position
+    float saved_start_position[4];
+    float extruder_multiplier;
+    uint32_t file_position;           //!< SD position or host line number
+    uint16_t feedrate;
+    uint16_t feedmultiply;
+    uint16_t extrudemultiply;
+    uint16_t target_hotend;
+    uint16_t segment_idx;
+    uint8_t target_bed;
+    uint8_t fan_speed;
+    uint8_t print_type;
+    uint8_t e_abs;
+    uint8_t z_lifted;
+    uint16_t crc;                     //!< CRC16 CCITT of all previous bytes
+} uvlo_record_t;
+
+static_assert(sizeof(uvlo_record_t) <= 256, "record must fit a single page program");
+
+/// Result of scanning the record slots
+typedef struct
+{
+    int8_t valid_slot;  //!< slot of the newest valid record, -1 if there is none
+    uint8_t next_slot;  //!< slot which is going to receive the next record
+    uint16_t next_seq;  //!< sequence number for the next record
+} uvlo_record_scan_t;
+
+/// Reads cnt bytes from flash at addr (xflash_rd_data() on the printer)
+typedef void (*uvlo_record_rd_t)(uint32_t addr, uint8_t* data, uint16_t cnt);
+
+/// Set the magic, sequence number and CRC of a filled-in record
+void uvlo_record_seal(uvlo_record_t& rec, uint16_t seq);
+
+/// @return true if the record carries the magic and a matching CRC
+bool uvlo_record_valid(const uvlo_record_t& rec);
+
+/// @return true if the record area is erased and can be programmed
+bool uvlo_record_blank(const uvlo_record_t& rec);
+
+/// Scan all slots starting at base.
+/// @param rec receives the newest valid record if there is one
+uvlo_record_scan_t uvlo_record_scan(uint32_t base, uvlo_record_rd_t rd, uvlo_record_t& rec);
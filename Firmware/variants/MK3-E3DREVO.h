@@ -138,6 +138,7 @@
 
 // Offline crash dumper
 #define XFLASH_DUMP     // enable dump functionality (including D20/D21/D22)
+#define XFLASH_DUMP_RLE // run-length encode the dump, fewer pages to program and sectors to erase
 #define MENU_DUMP       // enable "Memory dump" in Settings menu
 #define EMERGENCY_DUMP  // trigger crash on stack corruption and WDR
 
@@ -458,6 +459,11 @@
 // Maximum bed level correction value
 #define BED_ADJUSTMENT_UM_MAX 100
 
+// Keep the last mesh for G80 U, reused with the same sheet, bed and PINDA temperature
+#define MBL_CACHE
+#define MBL_CACHE_MAX_AGE 240        // printing time (min) after which the cached mesh expires
+#define MBL_CACHE_PINDA_TOLERANCE 3  // max. PINDA temperature difference (C)
+
 #define MESH_HOME_Z_CALIB 0.2
 #define MESH_HOME_Z_SEARCH 5.0f           // Z lift for homing, mesh bed leveling etc.
 
@@ -698,5 +704,7 @@
        calculated segment length is used. */
 #define DEFAULT_MIN_ARC_SEGMENTS 20 // The enforced minimum segments in a full circle of the same radius.  Set to 0 to disable
 #define DEFAULT_ARC_SEGMENTS_PER_SEC 0 // Use feedrate to choose segment length. Set to 0 to disable
+#define DEFAULT_ARC_MAX_CHORD_ERROR 0.005f // (mm) Allow segments longer than MM_PER_ARC_SEGMENT on large radii while the chord
+                                           // deviation from the true arc stays below this value. Set to 0 to disable
 
 #endif //__CONFIGURATION_PRUSA_H
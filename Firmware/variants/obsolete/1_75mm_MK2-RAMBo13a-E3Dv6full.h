@@ -428,5 +428,6 @@ THERMISTORS SETTINGS
        calculated segment length is used. */
 #define DEFAULT_MIN_ARC_SEGMENTS 20 // The enforced minimum segments in a full circle of the same radius.  Set to 0 to disable
 #define DEFAULT_ARC_SEGMENTS_PER_SEC 0 // Use feedrate to choose segment length. Set to 0 to disable
+#define DEFAULT_ARC_MAX_CHORD_ERROR 0 // (mm) Allow segments longer than MM_PER_ARC_SEGMENT on large radii within this chord error. Set to 0 to disable
 
 #endif //__CONFIGURATION_PRUSA_H
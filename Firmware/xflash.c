@@ -39,10 +39,10 @@
 #define _CS_LOW() WRITE(XFLASH_PIN_CS, 0)
 #define _CS_HIGH() WRITE(XFLASH_PIN_CS, 1)
 
-//#define _SPI_TX swspi_tx
-//#define _SPI_RX swspi_rx
 #define _SPI_TX(b)   spi_txrx(b)
 #define _SPI_RX()    spi_txrx(0xff)
+#define _SPI_TX_BLOCK(buf, cnt) spi_tx_block(buf, cnt)
+#define _SPI_RX_BLOCK(buf, cnt) spi_rx_block(buf, cnt)
 
 
 int xflash_mfrid_devid(void);
@@ -92,8 +92,7 @@ void xflash_rd_data(uint32_t addr, uint8_t* data, uint16_t cnt)
 {
 	_CS_LOW();
 	xflash_send_cmdaddr(_CMD_RD_DATA, addr);
-	while (cnt--)                        // receive data
-		*(data++) = _SPI_RX();
+	_SPI_RX_BLOCK(data, cnt);            // receive data
 	_CS_HIGH();
 }
 
@@ -101,8 +100,7 @@ void xflash_page_program(uint32_t addr, uint8_t* data, uint16_t cnt)
 {
 	_CS_LOW();
 	xflash_send_cmdaddr(_CMD_PAGE_PROGRAM, addr);
-	while (cnt--)                        // send data
-		_SPI_TX(*(data++));
+	_SPI_TX_BLOCK(data, cnt);            // send data
 	_CS_HIGH();
 }
 
@@ -128,6 +126,22 @@ void xflash_multipage_program(uint32_t addr, uint8_t* data, uint16_t cnt)
     }
 }
 
+void xflash_stream_program_start(uint32_t addr)
+{
+	_CS_LOW();
+	xflash_send_cmdaddr(_CMD_PAGE_PROGRAM, addr);
+}
+
+void xflash_stream_program_byte(uint8_t data)
+{
+	_SPI_TX(data);
+}
+
+void xflash_stream_program_end(void)
+{
+	_CS_HIGH();
+}
+
 void xflash_page_program_P(uint32_t addr, uint8_t* data, uint16_t cnt)
 {
 	_CS_LOW();
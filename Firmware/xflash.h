@@ -45,6 +45,12 @@ extern void xflash_page_program(uint32_t addr, uint8_t* data, uint16_t cnt);
 // write up to a single page of data from program memory
 extern void xflash_page_program_P(uint32_t addr, uint8_t* data, uint16_t cnt);
 
+// streaming page program: start a write at addr (write must be enabled), send data
+// byte by byte without crossing the page boundary, then end and wait until not busy
+extern void xflash_stream_program_start(uint32_t addr);
+extern void xflash_stream_program_byte(uint8_t data);
+extern void xflash_stream_program_end(void);
+
 // xflash_multipage_program: high-level interface for multi-page writes.
 //   Write any amount of data, chunking writes to page boundaries as needed.
 //   Automatically enables writes and waits for completion.
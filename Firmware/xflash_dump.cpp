@@ -28,6 +28,18 @@ bool xfdump_check_state(dump_crash_reason* reason)
 }
 
 
+uint16_t xfdump_stored_size()
+{
+    dump_header_t hdr;
+
+    XFLASH_SPI_ENTER();
+    xflash_rd_data(DUMP_OFFSET, (uint8_t*)&hdr, sizeof(hdr));
+    if (hdr.compression == DUMP_COMPRESSION_RLE)
+        return offsetof(dump_t, data) + hdr.data_size;
+    return sizeof(dump_t);
+}
+
+
 void xfdump_reset()
 {
     XFLASH_SPI_ENTER();
@@ -37,6 +49,7 @@ void xfdump_reset()
 }
 
 
+#ifndef XFLASH_DUMP_RLE
 static void xfdump_erase()
 {
     for(uint32_t addr = DUMP_OFFSET;
@@ -48,12 +61,140 @@ static void xfdump_erase()
         xflash_wait_busy();
     }
 }
+#endif //XFLASH_DUMP_RLE
+
+
+#ifdef XFLASH_DUMP_RLE
+// Next address of the compressed data stream
+static uint32_t xfdump_wr_addr;
+
+// Append a byte to the compressed data: pages are programmed as the data is produced
+// and each sector is only erased once the data reaches it, without any page buffer.
+static void xfdump_put(uint8_t data)
+{
+    if (!(xfdump_wr_addr & 0xFF))
+    {
+        // on a page boundary: finish the previous page (if any) and start a new one
+        xflash_stream_program_end();
+        xflash_wait_busy();
+        if (!(xfdump_wr_addr & 0xFFF))
+        {
+            xflash_enable_wr();
+            xflash_sector_erase(xfdump_wr_addr);
+            xflash_wait_busy();
+        }
+        xflash_enable_wr();
+        xflash_stream_program_start(xfdump_wr_addr);
+    }
+    xflash_stream_program_byte(data);
+    ++xfdump_wr_addr;
+}
+
+#define XFDUMP_RLE_MIN_RUN 3   // shorter runs are stored as literals
+#define XFDUMP_RLE_MAX_RUN 130 // 0x80 + (130 - XFDUMP_RLE_MIN_RUN) == 0xff
+#define XFDUMP_RLE_MAX_LIT 128
+
+static void xfdump_rle_fill(uint8_t value, uint16_t cnt)
+{
+    while (cnt)
+    {
+        uint8_t run = (cnt < XFDUMP_RLE_MAX_RUN)? cnt: XFDUMP_RLE_MAX_RUN;
+        if (run < XFDUMP_RLE_MIN_RUN)
+        {
+            xfdump_put(run - 1);
+            for (uint8_t i = 0; i < run; ++i)
+                xfdump_put(value);
+        }
+        else
+        {
+            xfdump_put(0x80 | (run - XFDUMP_RLE_MIN_RUN));
+            xfdump_put(value);
+        }
+        cnt -= run;
+    }
+}
+
+// read memory by address, including address 0 (registers)
+static inline uint8_t xfdump_rd(uint16_t addr)
+{
+    return *(const volatile uint8_t*)addr;
+}
+
+// Run-length encode memory directly from its location: a control byte c < 0x80 is
+// followed by c+1 literal bytes, c >= 0x80 by a single byte repeated c-0x80+3 times.
+// Unused stack and buffers are mostly zeros, so SRAM compresses well.
+static void xfdump_rle(uint16_t addr, uint16_t cnt)
+{
+    while (cnt)
+    {
+        const uint8_t value = xfdump_rd(addr);
+        uint8_t run = 1;
+        while (run < cnt && run < XFDUMP_RLE_MAX_RUN && xfdump_rd(addr + run) == value)
+            ++run;
+        if (run >= XFDUMP_RLE_MIN_RUN)
+        {
+            xfdump_put(0x80 | (run - XFDUMP_RLE_MIN_RUN));
+            xfdump_put(value);
+            addr += run;
+            cnt -= run;
+            continue;
+        }
+
+        // literals up to the next run
+        uint8_t lit = 0;
+        while (lit < cnt && lit < XFDUMP_RLE_MAX_LIT)
+        {
+            if ((uint16_t)(lit + 2) < cnt
+                && xfdump_rd(addr + lit) == xfdump_rd(addr + lit + 1)
+                && xfdump_rd(addr + lit) == xfdump_rd(addr + lit + 2))
+                break;
+            ++lit;
+        }
+        xfdump_put(lit - 1);
+        for (uint8_t i = 0; i < lit; ++i)
+            xfdump_put(xfdump_rd(addr + i));
+        addr += lit;
+        cnt -= lit;
+    }
+}
+#endif //XFLASH_DUMP_RLE
 
 
 static void __attribute__((noinline)) xfdump_dump_core(dump_header_t& hdr, uint32_t addr, uint8_t* buf, uint16_t cnt)
 {
     XFLASH_SPI_ENTER();
 
+    static_assert(sizeof(hdr) <= 256, "header is larger than a single page write");
+    static_assert(sizeof(dump_t::data) <= RAMEND+1, "dump area size insufficient");
+
+#ifdef XFLASH_DUMP_RLE
+    // worst case: one control byte every XFDUMP_RLE_MAX_LIT literals, plus the register fill
+    static_assert(offsetof(dump_t, data) + sizeof(dump_t::data) + sizeof(dump_t::data) / XFDUMP_RLE_MAX_LIT + 8
+                  <= DUMP_SIZE, "compressed dump may not fit");
+
+    // only clear the first sector, the rest is erased as needed
+    xflash_enable_wr();
+    xflash_sector_erase(DUMP_OFFSET);
+    xflash_wait_busy();
+
+    // sample SP/PC
+    hdr.sp = SP;
+    hdr.pc = GETPC();
+
+    // write data, the skipped register area reads back as erased flash
+    xfdump_wr_addr = DUMP_OFFSET + offsetof(dump_t, data);
+    xfdump_rle_fill(0xff, addr - xfdump_wr_addr);
+    xfdump_rle((uint16_t)buf, cnt);
+    xflash_stream_program_end();
+    xflash_wait_busy();
+
+    // write header last: the dump is valid only once complete
+    hdr.compression = DUMP_COMPRESSION_RLE;
+    hdr.data_size = xfdump_wr_addr - (DUMP_OFFSET + offsetof(dump_t, data));
+    xflash_enable_wr();
+    xflash_page_program(DUMP_OFFSET, (uint8_t*)&hdr, sizeof(hdr));
+    xflash_wait_busy();
+#else
     // start by clearing all sectors (we need all of them in any case)
     xfdump_erase();
 
@@ -62,14 +203,15 @@ static void __attribute__((noinline)) xfdump_dump_core(dump_header_t& hdr, uint3
     hdr.pc = GETPC();
 
     // write header
-    static_assert(sizeof(hdr) <= 256, "header is larger than a single page write");
+    hdr.compression = DUMP_COMPRESSION_NONE;
+    hdr.data_size = 0xffff;
     xflash_enable_wr();
     xflash_page_program(DUMP_OFFSET, (uint8_t*)&hdr, sizeof(hdr));
     xflash_wait_busy();
 
     // write data
-    static_assert(sizeof(dump_t::data) <= RAMEND+1, "dump area size insufficient");
     xflash_multipage_program(addr, buf, cnt);
+#endif //XFLASH_DUMP_RLE
 }
 
 
@@ -19,6 +19,9 @@ void xfdump_dump();     // create a new SRAM memory dump
 // return true if a dump is present, save type in "reason" if provided
 bool xfdump_check_state(dump_crash_reason* reason = NULL);
 
+// number of bytes used by the stored dump (header included), smaller if compressed
+uint16_t xfdump_stored_size();
+
 // create a new dump containing registers and SRAM, then reset
 void xfdump_full_dump_and_reset(dump_crash_reason crash = dump_crash_reason::manual);
 #endif
@@ -23,6 +23,7 @@
 
   ### 1. Languages (R)
     This is a variable size region that is built by the lang build scripts. More info can be found in those scripts.
+    The scripts check the packed language data against LANG_BIN_MAX, which must not exceed LANG_SIZE.
 
     It is aligned at the beginning of xflash, offset 0.
 
@@ -33,13 +34,21 @@
 
    It is aligned at the end of xflash, before xflash_dump
 
-  ### 3. xflash_dump (12KB, RW)
+  ### 3. Power panic record (8KB, RW)
+    Two 4KB sectors, each holding at most one uvlo_record_t at its start. The slot for the next record
+    is erased on boot, so that the power panic only needs a single page program. The newest record
+    (by sequence number) with a valid CRC is copied into EEPROM on the next boot and then cleared.
+
+    It is aligned before the MMU firmware update files.
+
+  ### 4. xflash_dump (12KB, RW)
     The crash dump structure is defined as dump_t.
     It composes of:
      - A header with some information such as crash reason and what info was dumped.
      - The dump itself. This is composed of the entire memory space from address 0 to the end of SRAM. So it includes also the registers (useless), the IO and extended IO (useful) and all RAM.
 
     Even though the dump needs around 9KB of storage, 12KB is used because of the sector erase size.
+    With XFLASH_DUMP_RLE the data is run-length encoded and only the sectors actually used are erased.
 
     It is aligned at the end of xflash.
 */
@@ -50,11 +59,15 @@
 #include <stdint.h>
 #include "bootapp.h" // for RAMSIZE
 #include "config.h"
+#include "uvlo_record.h"
 
 #define XFLASH_SIZE 0x40000ul // size of XFLASH
 
 #define DUMP_MAGIC  0x55525547ul
 
+#define DUMP_COMPRESSION_NONE 0xff // same as erased flash, for dumps written before compression existed
+#define DUMP_COMPRESSION_RLE  0x01 // see xfdump_rle() for the format
+
 struct dump_header_t
 {
     // start with a magic value to indicate the presence of a dump, so that clearing
@@ -66,6 +79,9 @@ struct dump_header_t
 
     uint32_t pc;          // PC nearby the crash location
     uint16_t sp;          // SP nearby the crash location
+
+    uint8_t compression;  // DUMP_COMPRESSION_*
+    uint16_t data_size;   // size of the compressed data (0xffff if not compressed)
 };
 
 struct dump_data_t
@@ -87,7 +103,9 @@ struct dump_t
 #define DUMP_OFFSET ((XFLASH_SIZE - sizeof(dump_t)) & ~0xFFFul) // dump offset must be aligned to lower 4kb sector boundary
 #define MMU_BOOTLOADER_UPDATE_OFFSET (DUMP_OFFSET - 32768) // 32KB of MMU bootloader self update.
 #define MMU_FW_UPDATE_OFFSET (MMU_BOOTLOADER_UPDATE_OFFSET - 32768) // 32KB of MMU fw.
+#define UVLO_RECORD_OFFSET (MMU_FW_UPDATE_OFFSET - UVLO_RECORD_SLOTS * UVLO_RECORD_SLOT_SIZE) // 8KB of power panic records.
 #define LANG_OFFSET 0x0 // offset for language data
 
-#define LANG_SIZE (MMU_FW_UPDATE_OFFSET - LANG_OFFSET) // available language space
+#define LANG_SIZE (UVLO_RECORD_OFFSET - LANG_OFFSET) // available language space
+#define LANG_BIN_MAX 0x2B000 // size limit of the packed language data, LANG_SIZE (read by the build scripts)
 #define DUMP_SIZE (XFLASH_SIZE - DUMP_OFFSET) // effective dump size area
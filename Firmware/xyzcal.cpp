@@ -9,6 +9,7 @@
 #include "stepper.h"
 #include "temperature.h"
 #include "sm4.h"
+#include "xyzcal_pattern.h"
 
 #define XYZCAL_PINDA_HYST_MIN 20  //50um
 #define XYZCAL_PINDA_HYST_MAX 100 //250um
@@ -650,58 +651,6 @@ void __attribute__((noinline)) xyzcal_scan_pixels_32x32_Zhop(int16_t cx, int16_t
 	DBG(endl);
 }
 
-/// Returns rate of match
-/// max match = 132, min match = 0
-uint8_t xyzcal_match_pattern_12x12_in_32x32(uint16_t* pattern, uint8_t* pixels, uint8_t c, uint8_t r){
-	uint8_t thr = 16;
-	uint8_t match = 0;
-	for (uint8_t i = 0; i < 12; ++i){
-		for (uint8_t j = 0; j < 12; ++j){
-			/// skip corners (3 pixels in each)
-			if (((i == 0) || (i == 11)) && ((j < 2) || (j >= 10))) continue;
-			if (((j == 0) || (j == 11)) && ((i < 2) || (i >= 10))) continue;
-			const uint16_t idx = (c + j) + 32 * ((uint16_t)r + i);
-			const bool high_pix = pixels[idx] > thr;
-			const bool high_pat = pattern[i] & (1 << j);
-			if (high_pix == high_pat)
-				match++;
-		}
-	}
-	return match;
-}
-
-/// Searches for best match of pattern by shifting it
-/// Returns rate of match and the best location
-/// max match = 132, min match = 0
-uint8_t xyzcal_find_pattern_12x12_in_32x32(uint8_t* pixels, uint16_t* pattern, uint8_t* pc, uint8_t* pr){
-	if (!pixels || !pattern || !pc || !pr)
-		return -1;
-	uint8_t max_c = 0;
-	uint8_t max_r = 0;
-	uint8_t max_match = 0;
-
-	// DBG(_n("Matching:\n"));
-	/// pixel precision
-	for (uint8_t r = 0; r < (32 - 12); ++r){
-		for (uint8_t c = 0; c < (32 - 12); ++c){
-			const uint8_t match = xyzcal_match_pattern_12x12_in_32x32(pattern, pixels, c, r);
-			if (max_match < match){
-				max_c = c;
-				max_r = r;
-				max_match = match;
-			}
-			// DBG(_n("%d "), match);
-		}
-		// DBG(_n("\n"));
-	}
-    //@size=278
-	DBG(_n("Pattern center [%f %f], match %f%%\n"), max_c + 5.5f, max_r + 5.5f, max_match / 1.32f);
-
-	*pc = max_c;
-	*pr = max_r;
-	return max_match;
-}
-
 const uint16_t xyzcal_point_pattern_10[12] PROGMEM = {0x000, 0x0f0, 0x1f8, 0x3fc, 0x7fe, 0x7fe, 0x7fe, 0x7fe, 0x3fc, 0x1f8, 0x0f0, 0x000};
 const uint16_t xyzcal_point_pattern_08[12] PROGMEM = {0x000, 0x000, 0x0f0, 0x1f8, 0x3fc, 0x3fc, 0x3fc, 0x3fc, 0x1f8, 0x0f0, 0x000, 0x000};
 
@@ -886,9 +835,9 @@ void print_image(const uint8_t *matrix_32x32){
 	DBG(endl);
 }
 
-/// Takes two patterns and searches them in matrix32
+/// Takes two patterns and searches them in the thresholded rows of matrix32
 /// \returns best match
-uint8_t find_patterns(uint8_t *matrix32, uint16_t *pattern08, uint16_t *pattern10, uint8_t &col, uint8_t &row){
+uint8_t find_patterns(uint32_t *rows32, uint16_t *pattern08, uint16_t *pattern10, uint8_t &col, uint8_t &row){
 	uint8_t c08 = 0;
 	uint8_t r08 = 0;
 	uint8_t match08 = 0;
@@ -896,8 +845,11 @@ uint8_t find_patterns(uint8_t *matrix32, uint16_t *pattern08, uint16_t *pattern1
 	uint8_t r10 = 0;
 	uint8_t match10 = 0;
 
-	match08 = xyzcal_find_pattern_12x12_in_32x32(matrix32, pattern08, &c08, &r08);
-	match10 = xyzcal_find_pattern_12x12_in_32x32(matrix32, pattern10, &c10, &r10);
+	match08 = xyzcal_find_pattern_12x12_in_32x32(rows32, pattern08, &c08, &r08);
+    //@size=278
+	DBG(_n("Pattern center [%f %f], match %f%%\n"), c08 + 5.5f, r08 + 5.5f, match08 / 1.32f);
+	match10 = xyzcal_find_pattern_12x12_in_32x32(rows32, pattern10, &c10, &r10);
+	DBG(_n("Pattern center [%f %f], match %f%%\n"), c10 + 5.5f, r10 + 5.5f, match10 / 1.32f);
 
 	if (match08 > match10){
 		col = c08;
@@ -953,6 +905,8 @@ BedSkewOffsetDetectionResultType xyzcal_scan_and_process(){
 	uint8_t *matrix32 = (uint8_t *)block_buffer;
 	uint16_t *pattern08 = (uint16_t *)(matrix32 + 32 * 32);
 	uint16_t *pattern10 = (uint16_t *)(pattern08 + 12);
+	uint32_t *rows32 = (uint32_t *)(pattern10 + 12);
+	static_assert(sizeof(block_t) * BLOCK_BUFFER_SIZE >= 32 * 32 + 2 * 12 * sizeof(uint16_t) + 32 * sizeof(uint32_t), "block_buffer too small for the image");
 
 	for (uint8_t i = 0; i < 12; i++){
 		pattern08[i] = pgm_read_word((uint16_t*)(xyzcal_point_pattern_08 + i));
@@ -967,9 +921,10 @@ BedSkewOffsetDetectionResultType xyzcal_scan_and_process(){
 	/// SEARCH FOR BINARY CIRCLE
 	uint8_t uc = 0;
 	uint8_t ur = 0;
+	xyzcal_threshold_32x32(matrix32, rows32);
 
 	/// max match = 132, 1/2 good = 66, 2/3 good = 88
-	if (find_patterns(matrix32, pattern08, pattern10, uc, ur) >= 88){
+	if (find_patterns(rows32, pattern08, pattern10, uc, ur) >= 88){
 		/// find precise circle
 		/// move to the center of the pattern (+5.5)
 		float xf = uc + 5.5f;
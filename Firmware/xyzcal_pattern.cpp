@@ -0,0 +1,68 @@
+/// @file
+#include "xyzcal_pattern.h"
+
+void xyzcal_threshold_32x32(const uint8_t* pixels, uint32_t* rows){
+	for (uint8_t r = 0; r < 32; ++r){
+		uint32_t row = 0;
+		for (uint8_t c = 32; c-- > 0;){
+			row <<= 1;
+			if (pixels[(uint16_t)r * 32 + c] > XYZCAL_PIXEL_THRESHOLD)
+				row |= 1;
+		}
+		rows[r] = row;
+	}
+}
+
+/// Pixels compared in row i of the pattern, skips the corners (3 pixels in each)
+static inline uint16_t pattern_row_mask(uint8_t i){
+	if ((i == 0) || (i == 11))
+		return 0x3fc;
+	if ((i == 1) || (i == 10))
+		return 0x7fe;
+	return 0xfff;
+}
+
+/// Rate of match of the pattern against 12 rows, the pattern columns are in the lowest 12 bits
+static uint8_t match_window(const uint16_t* pattern, const uint32_t* window){
+	uint8_t match = 0;
+	for (uint8_t i = 0; i < 12; ++i)
+		match += __builtin_popcount(~((uint16_t)window[i] ^ pattern[i]) & pattern_row_mask(i));
+	return match;
+}
+
+uint8_t xyzcal_match_pattern_12x12_in_32x32(const uint16_t* pattern, const uint32_t* rows, uint8_t c, uint8_t r){
+	uint32_t window[12];
+	for (uint8_t i = 0; i < 12; ++i)
+		window[i] = rows[r + i] >> c;
+	return match_window(pattern, window);
+}
+
+uint8_t xyzcal_find_pattern_12x12_in_32x32(const uint32_t* rows, const uint16_t* pattern, uint8_t* pc, uint8_t* pr){
+	if (!rows || !pattern || !pc || !pr)
+		return -1;
+	uint8_t max_c = 0;
+	uint8_t max_r = 0;
+	uint8_t max_match = 0;
+
+	/// pixel precision
+	for (uint8_t r = 0; r < (32 - 12); ++r){
+		/// shift the rows by one column per step instead of by c for every match
+		uint32_t window[12];
+		for (uint8_t i = 0; i < 12; ++i)
+			window[i] = rows[r + i];
+		for (uint8_t c = 0; c < (32 - 12); ++c){
+			const uint8_t match = match_window(pattern, window);
+			if (max_match < match){
+				max_c = c;
+				max_r = r;
+				max_match = match;
+			}
+			for (uint8_t i = 0; i < 12; ++i)
+				window[i] >>= 1;
+		}
+	}
+
+	*pc = max_c;
+	*pr = max_r;
+	return max_match;
+}
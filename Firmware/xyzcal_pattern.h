@@ -0,0 +1,19 @@
+/// @file
+/// Search of the calibration point pattern in the 32x32 image scanned by xyzcal.
+#pragma once
+#include <stdint.h>
+
+/// Pixels above the threshold are taken as the calibration point
+#define XYZCAL_PIXEL_THRESHOLD 16
+
+/// Threshold the 32x32 scan once, bit c of rows[r] is set for the pixel in column c of row r.
+void xyzcal_threshold_32x32(const uint8_t* pixels, uint32_t* rows);
+
+/// Returns rate of match of the pattern placed at column c and row r
+/// max match = 132, min match = 0
+uint8_t xyzcal_match_pattern_12x12_in_32x32(const uint16_t* pattern, const uint32_t* rows, uint8_t c, uint8_t r);
+
+/// Searches for best match of pattern by shifting it
+/// Returns rate of match and the best location
+/// max match = 132, min match = 0
+uint8_t xyzcal_find_pattern_12x12_in_32x32(const uint32_t* rows, const uint16_t* pattern, uint8_t* pc, uint8_t* pr);
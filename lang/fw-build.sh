@@ -109,8 +109,9 @@ if [ "$has_xflash" = 1 ]; then
     lang_size=$(stat -c '%s' "$TMPDIR/lang.bin")
     lang_size_pad=$(( ($lang_size+4096-1) / 4096 * 4096 ))
 
-    # TODO: hard-coded! get value by preprocessing LANG_SIZE from xflash_layout.h!
-    lang_reserved=249856
+    # LANG_BIN_MAX is checked against LANG_SIZE when the firmware is compiled
+    lang_reserved_hex=$(grep --max-count=1 "^#define LANG_BIN_MAX *" $SRCDIR/Firmware/xflash_layout.h|sed -e's/  */ /g'|cut -d ' ' -f3|cut -d 'x' -f2)
+    lang_reserved=$((16#$lang_reserved_hex))
 
     echo >&2
     echo -n "  total size usage: " >&2
@@ -0,0 +1,110 @@
+/**
+ * @file
+ * @brief Filament jam detection, replaying extruder step and PAT9125 motion traces.
+ */
+
+#include "catch2/catch_test_macros.hpp"
+#include "../Firmware/fsensor_jam.h"
+
+#include <stdlib.h>
+#include <vector>
+
+// Extruder steps and sensor counts per chunk of 1.25mm, as evaluated by PAT9125_sensor::updatePAT9125()
+struct Chunk {
+    int16_t steps;
+    int16_t motion;
+};
+
+static const int16_t chunk_steps = 350; // 1.25mm at 280 steps/mm
+static const int16_t counts = 30;       // sensor counts per chunk of filament motion
+
+// Former detection: only the direction, jam after more than 10 net errors
+static int replay_legacy(const std::vector<Chunk>& trace)
+{
+    uint8_t err = 0;
+    for (size_t i = 0; i < trace.size(); ++i) {
+        const bool fsDir = trace[i].motion > 0;
+        const bool stDir = trace[i].steps > 0;
+        if (fsDir != stDir)
+            err++;
+        else if (err)
+            err--;
+        if (err > 10)
+            return (int)i;
+    }
+    return -1;
+}
+
+static int replay(const std::vector<Chunk>& trace)
+{
+    FSensorJamDetector jam;
+    jam.reset();
+    for (size_t i = 0; i < trace.size(); ++i) {
+        if (jam.chunk(trace[i].steps, trace[i].motion))
+            return (int)i;
+    }
+    return -1;
+}
+
+// Printing with retractions every few chunks, sensor noise of +-3 counts while moving, +-1 when stuck
+static std::vector<Chunk> print_trace(size_t n, int jam_at = -1)
+{
+    std::vector<Chunk> trace;
+    srand(1);
+    for (size_t i = 0; i < n; ++i) {
+        const bool retract = (i % 7) == 6;
+        const int16_t steps = retract ? -chunk_steps : chunk_steps;
+        int16_t motion = (retract ? -counts : counts) + (rand() % 7) - 3;
+        if (jam_at >= 0 && (int)i >= jam_at)
+            motion = (rand() % 3) - 1;
+        trace.push_back({ steps, motion });
+    }
+    return trace;
+}
+
+TEST_CASE( "Filament follows the extruder", "[fsensor_jam]" )
+{
+    CHECK(replay(print_trace(1000)) == -1);
+    CHECK(replay_legacy(print_trace(1000)) == -1);
+}
+
+TEST_CASE( "Single glitches are tolerated", "[fsensor_jam]" )
+{
+    std::vector<Chunk> trace = print_trace(200);
+    for (size_t i = 10; i < trace.size(); i += 3)
+        trace[i].motion = 0;
+    CHECK(replay(trace) == -1);
+}
+
+TEST_CASE( "Jammed filament is detected", "[fsensor_jam]" )
+{
+    const int jam_at = 100;
+    const std::vector<Chunk> trace = print_trace(300, jam_at);
+    const int detected = replay(trace);
+    REQUIRE(detected >= jam_at);
+    CHECK(detected < jam_at + FSENSOR_JAM_WINDOW);
+    const int legacy = replay_legacy(trace);
+    CHECK(detected <= legacy);
+}
+
+TEST_CASE( "Stuck filament during retractions is detected", "[fsensor_jam]" )
+{
+    // The sensor does not move at all. The former check took no motion as a match while retracting.
+    std::vector<Chunk> trace;
+    for (size_t i = 0; i < 50; ++i)
+        trace.push_back({ (int16_t)((i & 1) ? -chunk_steps : chunk_steps), 0 });
+    CHECK(replay(trace) == FSENSOR_JAM_THRESHOLD - 1);
+    CHECK(replay_legacy(trace) == -1);
+}
+
+TEST_CASE( "History is cleared after a jam", "[fsensor_jam]" )
+{
+    FSensorJamDetector jam;
+    jam.reset();
+    for (uint8_t i = 0; i < FSENSOR_JAM_THRESHOLD - 1; ++i)
+        CHECK_FALSE(jam.chunk(chunk_steps, 0));
+    CHECK(jam.failures() == FSENSOR_JAM_THRESHOLD - 1);
+    CHECK(jam.chunk(chunk_steps, 0));
+    CHECK(jam.failures() == 0);
+    CHECK_FALSE(jam.chunk(chunk_steps, 0));
+}
@@ -0,0 +1,231 @@
+/**
+ * @file
+ * @brief Mesh bed leveling probe order, and a simulation of the G80 probing time
+ *        before and after the travel and probing changes.
+ */
+
+#include "catch2/catch_test_macros.hpp"
+#include "../Firmware/mesh_probe_order.h"
+
+#include <algorithm>
+#include <math.h>
+#include <stdio.h>
+#include <vector>
+
+static const uint8_t N = 7;
+
+static std::vector<uint8_t> order_of(const uint8_t* row_mask, uint8_t ix_start)
+{
+    uint8_t order[N * N];
+    const uint8_t n = mesh_probe_order(row_mask, N, N, ix_start, order);
+    return std::vector<uint8_t>(order, order + n);
+}
+
+// Former G80 order: fixed zig-zag over the whole grid, skipped points left out
+static std::vector<uint8_t> zigzag_of(const uint8_t* row_mask)
+{
+    std::vector<uint8_t> order;
+    for (uint8_t p = 0; p < N * N; ++p) {
+        uint8_t ix = p % N;
+        const uint8_t iy = p / N;
+        if (iy & 1) ix = (N - 1) - ix;
+        if (row_mask[iy] & (1 << ix))
+            order.push_back(iy * N + ix);
+    }
+    return order;
+}
+
+static void mask_full(uint8_t* row_mask)
+{
+    for (uint8_t iy = 0; iy < N; ++iy)
+        row_mask[iy] = (1 << N) - 1;
+}
+
+static void mask_3x3(uint8_t* row_mask)
+{
+    for (uint8_t iy = 0; iy < N; ++iy)
+        row_mask[iy] = (iy % 3) ? 0 : 0b1001001;
+}
+
+// Print area in the right part of the bed, with the 3x3 points probed as well (no Z calibration data)
+static void mask_area(uint8_t* row_mask)
+{
+    mask_3x3(row_mask);
+    for (uint8_t iy = 2; iy <= 4; ++iy)
+        row_mask[iy] |= 0b1111000;
+}
+
+TEST_CASE( "Probe order", "[mesh_probe_order]" )
+{
+    uint8_t row_mask[N];
+
+    SECTION( "Full grid from the left is the zig-zag" ) {
+        mask_full(row_mask);
+        CHECK(order_of(row_mask, 0) == zigzag_of(row_mask));
+    }
+
+    SECTION( "Full grid from the right starts with the right point" ) {
+        mask_full(row_mask);
+        const std::vector<uint8_t> order = order_of(row_mask, N - 1);
+        REQUIRE(order.size() == N * N);
+        CHECK(order[0] == N - 1);
+        CHECK(order[N] == N);
+    }
+
+    SECTION( "3x3 grid" ) {
+        mask_3x3(row_mask);
+        const std::vector<uint8_t> order = order_of(row_mask, 0);
+        CHECK(order == std::vector<uint8_t>({ 0, 3, 6, 27, 24, 21, 42, 45, 48 }));
+    }
+
+    SECTION( "Every point is visited once" ) {
+        mask_area(row_mask);
+        std::vector<uint8_t> order = order_of(row_mask, 0);
+        std::vector<uint8_t> zigzag = zigzag_of(row_mask);
+        CHECK(order.size() == zigzag.size());
+        std::sort(order.begin(), order.end());
+        std::sort(zigzag.begin(), zigzag.end());
+        CHECK(order == zigzag);
+    }
+
+    SECTION( "Empty grid" ) {
+        for (uint8_t iy = 0; iy < N; ++iy)
+            row_mask[iy] = 0;
+        CHECK(order_of(row_mask, 0).empty());
+    }
+}
+
+// Time model of the G80 probing. Axes move with a trapezoidal profile,
+// a combined move takes as long as its slowest axis.
+static const float bed_x0 = 24.f, bed_y0 = 5.f, mesh_density = 34.f;
+static const float xy_feedrate = 150.f, xy_accel = 1000.f;   // (homing_feedrate[X_AXIS] * 3) / 60, DEFAULT_MAX_ACCELERATION
+static const float z_feedrate = 12.f, z_accel = 200.f;       // DEFAULT_MAX_FEEDRATE, DEFAULT_MAX_ACCELERATION
+static const float z_slow_feedrate = 800.f / (4 * 60);      // homing_feedrate[Z_AXIS] / (4 * 60)
+static const float mesh_home_z_search = 5.f;
+static const float mesh_home_z_search_fast = 0.35f;
+
+static float move_time(float d, float v, float a)
+{
+    d = fabsf(d);
+    if (d * a < v * v) // no cruise phase
+        return 2.f * sqrtf(d / a);
+    return d / v + v / a;
+}
+
+static float bed_z(uint8_t p)
+{
+    const float x = p % N, y = p / N;
+    return 0.15f * sinf(x * 0.6f) + 0.1f * cosf(y * 0.8f) + 0.02f * x;
+}
+
+static float xy_dist(uint8_t a, uint8_t b)
+{
+    return mesh_density * hypotf(float(a % N) - float(b % N), float(a / N) - float(b / N));
+}
+
+static float touch_time(float from, float to, float v)
+{
+    return move_time(from - to, v, z_accel);
+}
+
+// Former G80: zig-zag, Z lift and XY travel as separate moves, one fast and n_iter slow touches.
+static float simulate_before(const std::vector<uint8_t>& order, bool has_z, uint8_t n_iter)
+{
+    float t = 0, z = 0, x = bed_x0, y = bed_y0;
+    t += move_time(mesh_home_z_search - z, z_feedrate, z_accel);
+    z = mesh_home_z_search;
+    for (uint8_t p : order) {
+        const float init_z = has_z ? bed_z(p) + mesh_home_z_search_fast : mesh_home_z_search;
+        if (init_z > z) {
+            t += move_time(init_z - z, z_feedrate, z_accel);
+            z = init_z;
+        }
+        const float px = bed_x0 + (p % N) * mesh_density, py = bed_y0 + (p / N) * mesh_density;
+        t += move_time(hypotf(px - x, py - y), xy_feedrate, xy_accel);
+        x = px; y = py;
+        t += touch_time(z, bed_z(p), z_feedrate);
+        for (uint8_t i = 0; i < n_iter; ++i)
+            t += touch_time(0.2f, 0, z_feedrate) + touch_time(0.2f, 0, z_slow_feedrate);
+        z = bed_z(p);
+    }
+    return t;
+}
+
+// Current G80: row order adapted to the head, early exit after two agreeing touches. With the Z calibration
+// data Z is lifted clear of the last point, the travel is a combined XYZ move to the predicted height and
+// the fast touch is skipped. Without it Z is lifted to the search height before the XY travel.
+static float simulate_after(const std::vector<uint8_t>& order, bool has_z)
+{
+    float t = 0, z = 0, x = bed_x0, y = bed_y0;
+    t += move_time(mesh_home_z_search - z, z_feedrate, z_accel);
+    z = mesh_home_z_search;
+    float z_clear = 0;
+    for (uint8_t p : order) {
+        const float init_z = has_z ? bed_z(p) + mesh_home_z_search_fast : mesh_home_z_search;
+        if (has_z && z_clear > z) {
+            t += move_time(z_clear - z, z_feedrate, z_accel);
+            z = z_clear;
+        }
+        const float px = bed_x0 + (p % N) * mesh_density, py = bed_y0 + (p / N) * mesh_density;
+        const float t_xy = move_time(hypotf(px - x, py - y), xy_feedrate, xy_accel);
+        const float t_z = move_time(init_z - z, z_feedrate, z_accel);
+        t += has_z ? ((t_xy > t_z) ? t_xy : t_z) : t_z + t_xy;
+        x = px; y = py;
+        if (has_z) {
+            t += touch_time(init_z, bed_z(p), z_slow_feedrate);
+        } else {
+            t += touch_time(init_z, bed_z(p), z_feedrate);
+            t += touch_time(0.2f, 0, z_feedrate) + touch_time(0.2f, 0, z_slow_feedrate);
+        }
+        t += touch_time(0.2f, 0, z_feedrate) + touch_time(0.2f, 0, z_slow_feedrate);
+        z = bed_z(p);
+        z_clear = z + mesh_home_z_search_fast;
+    }
+    return t;
+}
+
+static float travel(const std::vector<uint8_t>& order)
+{
+    float d = 0;
+    for (size_t i = 1; i < order.size(); ++i)
+        d += xy_dist(order[i - 1], order[i]);
+    return d;
+}
+
+static const struct {
+    const char* name;
+    void (*mask)(uint8_t*);
+    bool has_z;
+} sim_cases[] = {
+    { "3x3", mask_3x3, false },
+    { "3x3 Z cal.", mask_3x3, true },
+    { "7x7", mask_full, false },
+    { "7x7 Z cal.", mask_full, true },
+    { "7x7 area", mask_area, false },
+};
+
+TEST_CASE( "Probing time simulation", "[mesh_probe_order]" )
+{
+    for (const auto& c : sim_cases) {
+        uint8_t row_mask[N];
+        c.mask(row_mask);
+        const std::vector<uint8_t> before = zigzag_of(row_mask);
+        const std::vector<uint8_t> after = order_of(row_mask, 0);
+        CHECK(travel(after) <= travel(before));
+        CHECK(simulate_after(after, c.has_z) < simulate_before(before, c.has_z, 3));
+    }
+}
+
+// Probing times before and after, run with: tests "[report]"
+TEST_CASE( "Probing time report", "[.][mesh_probe_order][report]" )
+{
+    printf("G80 simulation (3 probes per point)   before     after\n");
+    for (const auto& c : sim_cases) {
+        uint8_t row_mask[N];
+        c.mask(row_mask);
+        const std::vector<uint8_t> before = zigzag_of(row_mask);
+        const float t_before = simulate_before(before, c.has_z, 3);
+        const float t_after = simulate_after(order_of(row_mask, 0), c.has_z);
+        printf("  %-12s %2u points            %6.1f s  %6.1f s\n", c.name, (unsigned)before.size(), t_before, t_after);
+    }
+}
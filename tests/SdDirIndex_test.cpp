@@ -0,0 +1,209 @@
+/**
+ * @file
+ * @brief SD working directory index against a simulated FAT directory image, and the count of
+ *        directory entry reads done by the LCD file browser while scrolling.
+ */
+
+#include "catch2/catch_test_macros.hpp"
+#include "../Firmware/SdDirIndex.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+// 32 byte FAT directory entry, only the fields looked at by CardReader::lsDive()
+struct fat_dir_t {
+    uint8_t name[11];
+    uint8_t attributes;
+    uint8_t rest[20];
+};
+static_assert(sizeof(fat_dir_t) == 32, "FAT directory entry");
+
+static const uint8_t ATT_HIDDEN = 0x02;
+static const uint8_t ATT_DIRECTORY = 0x10;
+static const uint8_t ATT_LONG_NAME = 0x0F;
+static const uint8_t NAME_DELETED = 0xE5;
+
+class DirImage {
+public:
+    void add(const char *sfn, uint8_t attributes, uint8_t lfn_entries = 0) {
+        for (uint8_t i = lfn_entries; i > 0; --i) {
+            fat_dir_t e = {};
+            e.name[0] = (i == lfn_entries ? 0x40 : 0) | i;
+            e.attributes = ATT_LONG_NAME;
+            entries.push_back(e);
+        }
+        fat_dir_t e = {};
+        memset(e.name, ' ', sizeof(e.name));
+        memcpy(e.name, sfn, strlen(sfn));
+        e.attributes = attributes;
+        entries.push_back(e);
+    }
+
+    void file(unsigned n) {
+        char sfn[12];
+        snprintf(sfn, sizeof(sfn), "F%05u  GCO", n);
+        add(sfn, 0, 1 + n % 3);
+    }
+
+    /// Walk the directory the same way as lsDive(LS_GetFilename) and return the directory entry
+    /// index of the skip-th visible file after dir_entry. Calls index.add() for every file on a full walk.
+    int find(uint16_t dir_entry, uint16_t skip, SdDirIndex *index = nullptr) {
+        uint16_t cnt = 0;
+        for (uint16_t pos = dir_entry; pos < entries.size();) {
+            const uint16_t start = pos;
+            // SdBaseFile::readDir(): collect the LFN entries up to the short entry
+            const fat_dir_t *e;
+            do {
+                e = &entries[pos++];
+                ++reads;
+                if (e->name[0] == 0)
+                    return -1;
+            } while ((e->name[0] == NAME_DELETED || e->name[0] == '.' || e->attributes == ATT_LONG_NAME) && pos < entries.size());
+            if (e->attributes == ATT_LONG_NAME || (e->attributes & ATT_HIDDEN))
+                continue;
+            if (!(e->attributes & ATT_DIRECTORY) && (e->name[8] != 'G' || e->name[9] == '~'))
+                continue;
+            if (index)
+                index->add(cnt, start);
+            if (cnt++ == skip && !index)
+                return start;
+        }
+        return -1;
+    }
+
+    std::string name(int dir_entry) const {
+        while (entries[dir_entry].attributes == ATT_LONG_NAME)
+            ++dir_entry;
+        return std::string((const char *)entries[dir_entry].name, 11);
+    }
+
+    std::vector<fat_dir_t> entries;
+    unsigned long reads = 0;
+};
+
+// Folder as left behind by a slicer and a few deletions: G-codes, other files, subfolders
+static void make_dir(DirImage &dir, unsigned files) {
+    dir.add(".          ", ATT_DIRECTORY);
+    dir.add("..         ", ATT_DIRECTORY);
+    for (unsigned n = 0; n < files; ++n) {
+        if (n % 17 == 5)
+            dir.add("README  TXT", 0, 1);
+        if (n % 29 == 7)
+            dir.add("SUBDIR     ", ATT_DIRECTORY, 2);
+        if (n % 31 == 3) {
+            dir.add("DELETED GCO", 0);
+            dir.entries.back().name[0] = NAME_DELETED;
+        }
+        if (n % 37 == 11)
+            dir.add("HIDDEN  GCO", ATT_HIDDEN, 1);
+        dir.file(n);
+    }
+}
+
+static unsigned count_visible(DirImage &dir, SdDirIndex &index) {
+    index.reset();
+    dir.find(0, 0, &index);
+    return index.count();
+}
+
+// Former CardReader::getfilename(): rewind and walk
+static int lookup_walk(DirImage &dir, uint16_t nr) {
+    return dir.find(0, nr);
+}
+
+static int lookup_indexed(DirImage &dir, const SdDirIndex &index, uint16_t nr) {
+    uint16_t entry = 0;
+    const int32_t skip = index.seek(nr, entry);
+    REQUIRE(skip >= 0);
+    return dir.find(entry, skip);
+}
+
+TEST_CASE( "Indexed lookup returns the same file as the walk", "[sd_dir_index]" )
+{
+    for (unsigned files : { 0u, 1u, 31u, 32u, 33u, 64u, 100u, 257u, 600u }) {
+        DirImage dir;
+        make_dir(dir, files);
+        SdDirIndex index;
+        const unsigned visible = count_visible(dir, index);
+        CHECK(visible >= files);
+        for (uint16_t nr = 0; nr < visible; ++nr) {
+            const int a = lookup_walk(dir, nr);
+            const int b = lookup_indexed(dir, index, nr);
+            REQUIRE(a >= 0);
+            CHECK(a == b);
+            CHECK(dir.name(a) == dir.name(b));
+        }
+        CHECK(lookup_walk(dir, visible) == -1);
+    }
+}
+
+TEST_CASE( "Stride grows with the directory", "[sd_dir_index]" )
+{
+    SdDirIndex index;
+    index.reset();
+    uint16_t entry;
+    CHECK(index.seek(0, entry) == -1);
+
+    for (uint16_t nr = 0; nr < 1000; ++nr)
+        index.add(nr, nr * 3);
+    CHECK(index.count() == 1000);
+    for (uint16_t nr = 0; nr < 1000; ++nr) {
+        const int32_t skip = index.seek(nr, entry);
+        REQUIRE(skip >= 0);
+        CHECK(entry == (nr - skip) * 3);
+        // 1000 files over 32 checkpoints
+        CHECK(skip < 32);
+    }
+}
+
+// LCD file browser: every move of the encoder redraws the visible rows, each row loads its file name
+struct ScrollReads {
+    unsigned visible;
+    unsigned long walk, indexed; // entry reads per step
+};
+
+static ScrollReads scroll_reads(unsigned files) {
+    const unsigned rows = 3;
+    DirImage dir;
+    make_dir(dir, files);
+    SdDirIndex index;
+    const unsigned visible = count_visible(dir, index);
+
+    unsigned long walk = 0, indexed = 0;
+    for (unsigned top = 0; top + rows <= visible; ++top) {
+        for (unsigned r = 0; r < rows; ++r) {
+            dir.reads = 0;
+            lookup_walk(dir, visible - 1 - (top + r));
+            walk += dir.reads;
+            dir.reads = 0;
+            lookup_indexed(dir, index, visible - 1 - (top + r));
+            indexed += dir.reads;
+        }
+    }
+    const unsigned steps = visible - rows + 1;
+    return { visible, walk / steps, indexed / steps };
+}
+
+static const unsigned scroll_files[] = { 20u, 100u, 300u, 600u };
+
+TEST_CASE( "Directory entry reads per menu scroll", "[sd_dir_index]" )
+{
+    for (unsigned files : scroll_files) {
+        const ScrollReads r = scroll_reads(files);
+        CHECK(r.indexed <= r.walk);
+        if (r.visible > 2 * SD_DIR_INDEX_SIZE)
+            CHECK(r.indexed * 4 < r.walk);
+    }
+}
+
+// Entry reads before and after, run with: tests "[report]"
+TEST_CASE( "Directory entry reads report", "[.][sd_dir_index][report]" )
+{
+    printf("SD menu scroll, entry reads per step     walk   indexed\n");
+    for (unsigned files : scroll_files) {
+        const ScrollReads r = scroll_reads(files);
+        printf("  %4u files                           %7lu %9lu\n", r.visible, r.walk, r.indexed);
+    }
+}
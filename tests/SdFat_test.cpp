@@ -0,0 +1,330 @@
+/**
+ * @file
+ * @brief SdFat stack on a host disk image: correctness of the G-code reader and directory walk,
+ *        and benchmarks of the SD card paths used while printing and in the file browser.
+ */
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/benchmark/catch_benchmark.hpp"
+#include "SdHost.h"
+#include "../Firmware/SdFile.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+static const uint32_t image_blocks = 65536; // 32 MiB
+static const uint32_t command_latency_us = 400; // card access time of a command, see SD_HOST_BLOCK_US for the data
+
+// Exposes the plain read() of the file
+class TestFile : public SdFile {
+public:
+    using SdBaseFile::read;
+};
+
+class SdImage {
+public:
+    explicit SdImage(uint32_t latency_us = command_latency_us) {
+        REQUIRE(sd_host_create(image_blocks, latency_us));
+        REQUIRE(card.init());
+        REQUIRE(volume.init(&card));
+        REQUIRE(root.openRoot(&volume));
+    }
+    ~SdImage() {
+        root.close();
+        sd_host_close();
+    }
+
+    void write_file(SdBaseFile &dir, const char *name, const std::string &data) {
+        SdFile f;
+        REQUIRE(f.open(&dir, name, O_CREAT | O_WRITE | O_TRUNC));
+        for (size_t i = 0; i < data.size(); i += 512) {
+            const uint16_t n = std::min<size_t>(512, data.size() - i);
+            REQUIRE(f.write(data.data() + i, n) == n);
+        }
+        REQUIRE(f.close());
+    }
+
+    Sd2Card card;
+    SdVolume volume;
+    SdFile root;
+};
+
+// Sliced G-code like content: moves with comment blocks in between
+static std::string make_gcode(size_t size) {
+    std::string s;
+    char line[64];
+    for (unsigned i = 0; s.size() < size; ++i) {
+        if (i % 50 == 0) {
+            for (unsigned c = 0; c < 1 + i % 7; ++c) {
+                snprintf(line, sizeof(line), ";LAYER_CHANGE %u comment line %u\n", i, c);
+                s += line;
+            }
+        }
+        snprintf(line, sizeof(line), "G1 X%u.%03u Y%u.%03u E%u.%05u\n", i % 250, i % 1000, (i * 7) % 210, i % 997, i % 3, i % 99991);
+        s += line;
+    }
+    return s;
+}
+
+// Lines of the G-code without comment lines and empty lines.
+// readFilteredGcode() does not return the newline at the end of the file.
+static std::vector<std::string> code_lines(const std::string &s) {
+    std::vector<std::string> lines;
+    size_t start = 0;
+    for (size_t i = 0; i <= s.size(); ++i) {
+        if (i < s.size() && s[i] != '\n')
+            continue;
+        if (i > start && s[start] != ';')
+            lines.push_back(s.substr(start, i - start));
+        start = i + 1;
+    }
+    return lines;
+}
+
+static std::string read_filtered(SdFile &f) {
+    std::string out;
+    for (int16_t c; (c = f.readFilteredGcode()) >= 0;)
+        out += (char)c;
+    return out;
+}
+
+static void make_folder(SdImage &sd, SdBaseFile &dir, unsigned files) {
+    REQUIRE(dir.mkdir(&sd.root, "MANY"));
+    char name[16];
+    // Created in the reverse order of the names, the worst case for the sorting
+    for (unsigned i = files; i-- > 0;) {
+        snprintf(name, sizeof(name), "F%05u.GCO", i);
+        sd.write_file(dir, name, "G28\n");
+        if (i % 10 == 0)
+            sd.write_file(dir, (snprintf(name, sizeof(name), "R%05u.TXT", i), name), "readme\n");
+    }
+}
+
+// Count the G-code files in the same way as CardReader::lsDive(LS_Count)
+static unsigned count_files(SdBaseFile &dir, char *lfn, bool lazy) {
+    dir.rewind();
+    dir_t p;
+    unsigned n = 0;
+    while (dir.readDir(&p, lfn, lazy) > 0) {
+        if (lfn[0] == '.' || !DIR_IS_FILE_OR_SUBDIR(&p) || (p.attributes & DIR_ATT_HIDDEN))
+            continue;
+        if (!DIR_IS_SUBDIR(&p) && (p.name[8] != 'G' || p.name[9] == '~'))
+            continue;
+        ++n;
+    }
+    return n;
+}
+
+// Directory entries of the G-code files, as CardReader::presort() collects them
+static std::vector<uint16_t> file_entries(SdBaseFile &dir) {
+    std::vector<uint16_t> entries;
+    dir.rewind();
+    dir_t p;
+    for (uint32_t pos = dir.curPosition(); dir.readDir(&p, nullptr) > 0; pos = dir.curPosition())
+        if (p.name[8] == 'G')
+            entries.push_back(pos >> 5);
+    return entries;
+}
+
+static std::string entry_name(SdBaseFile &dir, uint16_t entry) {
+    dir.seekSet((uint32_t)entry << 5);
+    dir_t p;
+    dir.readDir(&p, nullptr);
+    return std::string((const char *)p.name, 11);
+}
+
+// Insertion sort re-reading the names from the card for every compare, as CardReader::presort()
+static void presort(SdBaseFile &dir, std::vector<uint16_t> &entries) {
+    for (size_t i = 1; i < entries.size(); ++i) {
+        const uint16_t o1 = entries[i];
+        const std::string name1 = entry_name(dir, o1);
+        size_t j = i;
+        for (; j > 0; --j) {
+            const uint16_t o2 = entries[j - 1];
+            if (entry_name(dir, o2) < name1)
+                break;
+            entries[j] = o2;
+        }
+        entries[j] = o1;
+    }
+}
+
+TEST_CASE( "Files written through SdFat read back", "[sdfat]" )
+{
+    SdImage sd(0);
+    const std::string gcode = make_gcode(100000);
+    sd.write_file(sd.root, "PRINT.GCO", gcode);
+
+    TestFile f;
+    REQUIRE(f.open(&sd.root, "PRINT.GCO", O_READ));
+    CHECK(f.fileSize() == gcode.size());
+    std::string back;
+    char buf[1000];
+    for (int16_t n; (n = f.read(buf, sizeof(buf))) > 0;)
+        back.append(buf, n);
+    CHECK(back == gcode);
+    f.close();
+
+    SECTION( "Filtered G-code" ) {
+        SdFile g;
+        REQUIRE(g.openFilteredGcode(&sd.root, "PRINT.GCO"));
+        CHECK(code_lines(read_filtered(g)) == code_lines(gcode));
+    }
+
+    SECTION( "Filtered G-code after a seek" ) {
+        SdFile g;
+        REQUIRE(g.openFilteredGcode(&sd.root, "PRINT.GCO"));
+        const uint32_t pos = gcode.find('\n', 60000) + 1;
+        REQUIRE(g.seekSetFilteredGcode(pos));
+        CHECK(code_lines(read_filtered(g)) == code_lines(gcode.substr(pos)));
+    }
+}
+
+TEST_CASE( "Directory walk", "[sdfat]" )
+{
+    SdImage sd(0);
+    SdFile dir;
+    make_folder(sd, dir, 300);
+    char lfn[LONG_FILENAME_LENGTH];
+
+    CHECK(count_files(dir, lfn, false) == 300);
+    CHECK(count_files(dir, lfn, true) == 300);
+
+    std::vector<uint16_t> entries = file_entries(dir);
+    REQUIRE(entries.size() == 300);
+    entries.resize(100);
+    presort(dir, entries);
+    for (size_t i = 1; i < entries.size(); ++i)
+        CHECK(entry_name(dir, entries[i - 1]) < entry_name(dir, entries[i]));
+}
+
+static void make_card(SdImage &sd, SdFile &dir, std::string &gcode) {
+    gcode = make_gcode(256 * 1024);
+    sd.write_file(sd.root, "PRINT.GCO", gcode);
+    make_folder(sd, dir, 300);
+}
+
+static void seek_around(SdFile &g, size_t size) {
+    for (uint32_t i = 0; i < 100; ++i) {
+        REQUIRE(g.seekSetFilteredGcode((i * 7919 * 64) % size));
+        g.readFilteredGcode();
+    }
+}
+
+// Card time of every operation with the simulated card latency. A FlashAir card
+// does single block transfers only, which gives the card time without CMD18 and CMD25.
+static void card_transfers(bool print) {
+    SdImage sd;
+    SdFile dir;
+    std::string gcode;
+    make_card(sd, dir, gcode);
+    char lfn[LONG_FILENAME_LENGTH];
+    const std::string data = make_gcode(64 * 1024);
+    const uint32_t blocks = (gcode.size() + 511) / 512;
+
+    if (print)
+        printf("SD card time, %u us per command        blocks  commands  card time\n", (unsigned)command_latency_us);
+    auto report = [print](const char *name, size_t bytes) {
+        if (!print)
+            return sd_host_stats.card_us;
+        printf("  %-34s %8u %8u %8.1f ms", name, (unsigned)(sd_host_stats.reads + sd_host_stats.writes),
+            (unsigned)sd_host_stats.commands, sd_host_stats.card_us / 1000.);
+        if (bytes)
+            printf("  %6.1f kB/s", bytes * 1000. / sd_host_stats.card_us);
+        printf("\n");
+        return sd_host_stats.card_us;
+    };
+
+    uint64_t read_us[2], write_us[2];
+    for (uint8_t single = 0; single < 2; ++single) {
+        sd.card.setFlashAirCompatible(single);
+        if (print)
+            printf(single ? " single block transfers\n" : " multiple block transfers\n");
+
+        TestFile f;
+        REQUIRE(f.open(&sd.root, "PRINT.GCO", O_READ));
+        sd_host_stats = sd_host_stats_t();
+        std::string back;
+        char buf[1024];
+        for (int16_t n; (n = f.read(buf, sizeof(buf))) > 0;)
+            back.append(buf, n);
+        read_us[single] = report("read() 256 kB", gcode.size());
+        CHECK(back == gcode);
+        f.close();
+
+        SdFile g;
+        REQUIRE(g.openFilteredGcode(&sd.root, "PRINT.GCO"));
+        sd_host_stats = sd_host_stats_t();
+        read_filtered(g);
+        report("readFilteredGcode() 256 kB", gcode.size());
+        // Every data block once, and the FAT at the start of every cluster
+        CHECK(sd_host_stats.reads <= blocks + (blocks + 3) / 4 + 1);
+
+        sd_host_stats = sd_host_stats_t();
+        char name[] = "OUT0.GCO";
+        name[3] += single;
+        sd.write_file(sd.root, name, data);
+        write_us[single] = report("write() 64 kB", data.size());
+
+        sd_host_stats = sd_host_stats_t();
+        CHECK(count_files(dir, lfn, true) == 300);
+        report("count 300 files", 0);
+
+        std::vector<uint16_t> entries = file_entries(dir);
+        entries.resize(100);
+        sd_host_stats = sd_host_stats_t();
+        presort(dir, entries);
+        report("presort 100 files", 0);
+
+        sd_host_stats = sd_host_stats_t();
+        seek_around(g, gcode.size());
+        report("100 seeks", 0);
+    }
+    CHECK(read_us[0] < read_us[1]);
+    CHECK(write_us[0] < write_us[1]);
+}
+
+TEST_CASE( "SD card transfers", "[sdfat]" )
+{
+    card_transfers(false);
+}
+
+// The card time table, run with: tests "[report]"
+TEST_CASE( "SD card transfers report", "[.][sdfat][report]" )
+{
+    card_transfers(true);
+}
+
+// Host CPU time of the same operations, run with: tests "[benchmark]"
+TEST_CASE( "SD card benchmarks", "[.][sdfat][benchmark]" )
+{
+    SdImage sd;
+    SdFile dir;
+    std::string gcode;
+    make_card(sd, dir, gcode);
+    char lfn[LONG_FILENAME_LENGTH];
+    SdFile g;
+    REQUIRE(g.openFilteredGcode(&sd.root, "PRINT.GCO"));
+
+    BENCHMARK( "readFilteredGcode() 256 kB" ) {
+        g.seekSetFilteredGcode(0);
+        return read_filtered(g).size();
+    };
+
+    BENCHMARK( "count 300 files" ) {
+        return count_files(dir, lfn, true);
+    };
+
+    BENCHMARK( "presort 100 files" ) {
+        std::vector<uint16_t> e = file_entries(dir);
+        e.resize(100);
+        std::reverse(e.begin(), e.end());
+        presort(dir, e);
+        return e[0];
+    };
+
+    BENCHMARK( "100 seeks" ) {
+        seek_around(g, gcode.size());
+    };
+}
@@ -0,0 +1,217 @@
+/**
+ * @file
+ * @brief Host implementation of Sd2Card on top of a disk image file, for the SdFat stack tests.
+ */
+
+#include "SdHost.h"
+#include "../Firmware/Sd2Card.h"
+
+SdHostSerial MYSERIAL;
+sd_host_stats_t sd_host_stats;
+
+static FILE *image;
+static uint32_t image_blocks;
+static uint32_t latency;
+static uint32_t stream_block; // next block of a multiple block transfer
+
+bool sd_host_open(const char *path, uint32_t latency_us) {
+    sd_host_close();
+    image = fopen(path, "r+b");
+    if (!image)
+        return false;
+    fseek(image, 0, SEEK_END);
+    image_blocks = ftell(image) / 512;
+    latency = latency_us;
+    sd_host_stats = sd_host_stats_t();
+    return true;
+}
+
+static void put16(uint8_t *p, uint16_t v) {
+    p[0] = v;
+    p[1] = v >> 8;
+}
+
+static void put32(uint8_t *p, uint32_t v) {
+    put16(p, v);
+    put16(p + 2, v >> 16);
+}
+
+// Super floppy FAT16 volume, boot sector in block zero
+bool sd_host_create(uint32_t blocks, uint32_t latency_us) {
+    const uint8_t blocks_per_cluster = 4;
+    const uint16_t reserved = 1, root_entries = 512;
+    const uint32_t root_blocks = root_entries * 32 / 512;
+    uint32_t fat_blocks = 1;
+    uint32_t clusters;
+    for (;;) {
+        clusters = (blocks - reserved - 2 * fat_blocks - root_blocks) / blocks_per_cluster;
+        const uint32_t need = ((clusters + 2) * 2 + 511) / 512;
+        if (need <= fat_blocks)
+            break;
+        fat_blocks = need;
+    }
+    if (clusters < 4085 || clusters >= 65525)
+        return false;
+
+    sd_host_close();
+    image = tmpfile();
+    if (!image)
+        return false;
+    uint8_t block[512] = {};
+    fseek(image, (long)(blocks - 1) * 512, SEEK_SET);
+    fwrite(block, 1, sizeof(block), image);
+
+    block[0] = 0xEB; block[1] = 0x3C; block[2] = 0x90;
+    memcpy(block + 3, "SDHOST  ", 8);
+    put16(block + 11, 512);
+    block[13] = blocks_per_cluster;
+    put16(block + 14, reserved);
+    block[16] = 2; // FAT count
+    put16(block + 17, root_entries);
+    if (blocks < 0x10000)
+        put16(block + 19, blocks);
+    else
+        put32(block + 32, blocks);
+    block[21] = 0xF8; // fixed disk
+    put16(block + 22, fat_blocks);
+    block[38] = 0x29; // extended boot signature
+    memcpy(block + 43, "NO NAME    FAT16   ", 19);
+    block[510] = 0x55; block[511] = 0xAA;
+    fseek(image, 0, SEEK_SET);
+    fwrite(block, 1, sizeof(block), image);
+
+    // Reserved clusters 0 and 1 in both FATs
+    memset(block, 0, sizeof(block));
+    put16(block, 0xFFF8);
+    put16(block + 2, 0xFFFF);
+    for (uint8_t fat = 0; fat < 2; ++fat) {
+        fseek(image, (long)(reserved + fat * fat_blocks) * 512, SEEK_SET);
+        fwrite(block, 1, sizeof(block), image);
+    }
+    fflush(image);
+
+    image_blocks = blocks;
+    latency = latency_us;
+    sd_host_stats = sd_host_stats_t();
+    return true;
+}
+
+void sd_host_close() {
+    if (image)
+        fclose(image);
+    image = nullptr;
+}
+
+static void command(uint8_t count = 1) {
+    sd_host_stats.commands += count;
+    sd_host_stats.card_us += count * latency;
+}
+
+static bool transfer(uint32_t block, uint8_t *dst, const uint8_t *src) {
+    if (!image || block >= image_blocks)
+        return false;
+    fseek(image, (long)block * 512, SEEK_SET);
+    if (latency)
+        sd_host_stats.card_us += SD_HOST_BLOCK_US;
+    if (dst) {
+        ++sd_host_stats.reads;
+        return fread(dst, 1, 512, image) == 512;
+    }
+    ++sd_host_stats.writes;
+    return fwrite(src, 1, 512, image) == 512;
+}
+
+// Like cardCommand() on the printer, any command ends an open multiple block transfer
+// and fails if the stop fails
+#define END_SEQUENCE() \
+    do { \
+        if (seq_ != SD_SEQ_NONE && !(seq_ == SD_SEQ_READ ? readStop() : writeStop())) \
+            return false; \
+    } while (0)
+
+bool Sd2Card::init(uint8_t sckRateID) {
+    errorCode_ = 0;
+    spiRate_ = sckRateID;
+    type_ = SD_CARD_TYPE_SDHC;
+    seq_ = SD_SEQ_NONE;
+    return image != nullptr;
+}
+
+uint32_t Sd2Card::cardSize() {
+    return image_blocks;
+}
+
+bool Sd2Card::setSckRate(uint8_t sckRateID) {
+    spiRate_ = sckRateID;
+    return true;
+}
+
+bool Sd2Card::erase(uint32_t firstBlock, uint32_t lastBlock) {
+    END_SEQUENCE();
+    command(3);
+    const uint8_t zero[512] = {};
+    for (uint32_t b = firstBlock; b <= lastBlock; ++b)
+        if (!transfer(b, nullptr, zero))
+            return false;
+    return true;
+}
+
+bool Sd2Card::eraseSingleBlockEnable() {
+    return true;
+}
+
+bool Sd2Card::readBlock(uint32_t block, uint8_t *dst) {
+    END_SEQUENCE();
+    command(); // CMD17
+    return transfer(block, dst, nullptr);
+}
+
+bool Sd2Card::readStart(uint32_t blockNumber) {
+    END_SEQUENCE();
+    command(); // CMD18
+    stream_block = blockNumber;
+    seq_ = SD_SEQ_READ;
+    return image != nullptr;
+}
+
+bool Sd2Card::readData(uint8_t *dst) {
+    if (seq_ != SD_SEQ_READ)
+        return false;
+    return transfer(stream_block++, dst, nullptr);
+}
+
+bool Sd2Card::readStop() {
+    seq_ = SD_SEQ_NONE;
+    command(); // CMD12
+    return true;
+}
+
+bool Sd2Card::writeBlock(uint32_t blockNumber, const uint8_t *src) {
+    END_SEQUENCE();
+    command(2); // CMD24 and CMD13
+    return transfer(blockNumber, nullptr, src);
+}
+
+bool Sd2Card::writeStart(uint32_t blockNumber, uint32_t) {
+    END_SEQUENCE();
+    command(3); // CMD55, ACMD23 and CMD25
+    stream_block = blockNumber;
+    seq_ = SD_SEQ_WRITE;
+    return image != nullptr;
+}
+
+bool Sd2Card::writeData(const uint8_t *src) {
+    if (seq_ != SD_SEQ_WRITE)
+        return false;
+    return transfer(stream_block++, nullptr, src);
+}
+
+bool Sd2Card::writeStop() {
+    seq_ = SD_SEQ_NONE;
+    command(4); // stop token and the busy wait, CMD13, CMD55 and ACMD22
+    return true;
+}
+
+uint8_t Sd2Card::readExtMemory(uint8_t, uint8_t, uint32_t, uint16_t, uint8_t *) {
+    return false;
+}
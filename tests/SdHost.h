@@ -0,0 +1,59 @@
+/**
+ * @file
+ * @brief Stand-in for Marlin.h in the host build of the SdFat stack, see SdHost.cpp.
+ *
+ * Force-included before the SdFat sources. It defines the include guard of Marlin.h,
+ * so the firmware header is skipped and only what the SD code needs is declared here.
+ */
+
+#ifndef TESTS_SDHOST_H_
+#define TESTS_SDHOST_H_
+
+#define MARLIN_H
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "avr/pgmspace.h"
+
+#define SDSUPPORT
+#define FORCE_INLINE inline
+#define PGM_P const char *
+#define DEC 10
+
+/// Serial output of the SdFat debug printing, discarded
+struct SdHostSerial {
+    void write(uint8_t) {}
+    void print(const char *) {}
+    void print(long, int = DEC) {}
+    void println() {}
+};
+extern SdHostSerial MYSERIAL;
+
+/// Card time of the data of one block, 512 bytes with SPI at 8 MHz and the CPU overhead
+#define SD_HOST_BLOCK_US 600
+
+/// Host block device behind Sd2Card, backed by a FAT disk image file
+/// @param path existing disk image, opened for reading and writing
+/// @param latency_us card time charged for every command, until the card responds with the data
+///        or finishes the write. Zero disables the time accounting, see sd_host_stats.
+/// @return false if the image cannot be opened
+bool sd_host_open(const char *path, uint32_t latency_us = 0);
+
+/// Open a temporary disk image of the given size, formatted as an empty FAT16 volume
+bool sd_host_create(uint32_t blocks, uint32_t latency_us = 0);
+
+void sd_host_close();
+
+/// Block transfers done since the image was opened. The card time is simulated,
+/// so that the results do not depend on the speed of the host.
+struct sd_host_stats_t {
+    uint32_t reads;
+    uint32_t writes;
+    uint32_t commands; ///< commands sent to the card, a multiple block transfer needs one for all its blocks
+    uint64_t card_us;  ///< sum of the latency of all the commands and block transfers
+};
+extern sd_host_stats_t sd_host_stats;
+
+#endif /* TESTS_SDHOST_H_ */
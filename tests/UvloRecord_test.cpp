@@ -0,0 +1,160 @@
+/**
+ * @file
+ * @brief Power panic record encoding and slot selection against a simulated XFLASH image.
+ */
+
+#include "catch2/catch_test_macros.hpp"
+#include "../Firmware/uvlo_record.h"
+
+#include <string.h>
+#include <vector>
+
+static const uint32_t base = 0x1000;
+static std::vector<uint8_t> image;
+
+static void image_erase()
+{
+    image.assign(base + UVLO_RECORD_SLOTS * UVLO_RECORD_SLOT_SIZE, 0xFF);
+}
+
+static void image_rd(uint32_t addr, uint8_t* data, uint16_t cnt)
+{
+    memcpy(data, &image[addr], cnt);
+}
+
+// NOR flash programming can only clear bits
+static void image_program(uint32_t addr, const void* data, uint16_t cnt)
+{
+    for (uint16_t i = 0; i < cnt; ++i)
+        image[addr + i] &= ((const uint8_t*)data)[i];
+}
+
+static uvlo_record_t make_record(float z)
+{
+    uvlo_record_t rec;
+    memset(&rec, 0, sizeof(rec));
+    rec.pos[0] = 10.5f;
+    rec.pos[1] = 20.25f;
+    rec.pos_z = z;
+    rec.pos_e = 1234.5f;
+    rec.file_position = 0x12345678;
+    rec.target_hotend = 215;
+    rec.target_bed = 60;
+    rec.print_type = 0;
+    return rec;
+}
+
+static void write_slot(uint8_t slot, const uvlo_record_t& rec)
+{
+    image_program(base + slot * UVLO_RECORD_SLOT_SIZE, &rec, sizeof(rec));
+}
+
+static void consume_slot(uint8_t slot)
+{
+    const uint32_t magic = UVLO_RECORD_CONSUMED;
+    image_program(base + slot * UVLO_RECORD_SLOT_SIZE, &magic, sizeof(magic));
+}
+
+TEST_CASE( "Record encode and decode", "[uvlo_record]" )
+{
+    uvlo_record_t rec = make_record(0.2f);
+    uvlo_record_seal(rec, 7);
+    CHECK(rec.magic == UVLO_RECORD_MAGIC);
+    CHECK(rec.seq == 7);
+    CHECK(uvlo_record_valid(rec));
+    CHECK_FALSE(uvlo_record_blank(rec));
+
+    // Round trip through a byte buffer, as done by the flash
+    uint8_t raw[sizeof(rec)];
+    memcpy(raw, &rec, sizeof(rec));
+    uvlo_record_t out;
+    memcpy(&out, raw, sizeof(out));
+    CHECK(uvlo_record_valid(out));
+    CHECK(out.pos_z == 0.2f);
+    CHECK(out.file_position == 0x12345678);
+    CHECK(out.target_bed == 60);
+
+    // Any corrupted byte is detected
+    for (size_t i = 0; i < sizeof(raw); ++i) {
+        memcpy(&out, raw, sizeof(out));
+        ((uint8_t*)&out)[i] ^= 0x10;
+        CHECK_FALSE(uvlo_record_valid(out));
+    }
+
+    uvlo_record_t blank;
+    memset(&blank, 0xFF, sizeof(blank));
+    CHECK(uvlo_record_blank(blank));
+    CHECK_FALSE(uvlo_record_valid(blank));
+}
+
+TEST_CASE( "Recovery from a simulated flash image", "[uvlo_record]" )
+{
+    uvlo_record_t out;
+    image_erase();
+
+    SECTION( "Erased image" ) {
+        const uvlo_record_scan_t scan = uvlo_record_scan(base, image_rd, out);
+        CHECK(scan.valid_slot == -1);
+        CHECK(scan.next_slot == 0);
+    }
+
+    SECTION( "Records alternate between the slots" ) {
+        uvlo_record_scan_t scan = uvlo_record_scan(base, image_rd, out);
+        for (uint8_t i = 0; i < 5; ++i) {
+            uvlo_record_t rec = make_record(i);
+            uvlo_record_seal(rec, scan.next_seq);
+            // the slot is erased before being written
+            memset(&image[base + scan.next_slot * UVLO_RECORD_SLOT_SIZE], 0xFF, UVLO_RECORD_SLOT_SIZE);
+            write_slot(scan.next_slot, rec);
+
+            const uint8_t written = scan.next_slot;
+            scan = uvlo_record_scan(base, image_rd, out);
+            REQUIRE(scan.valid_slot == written);
+            CHECK(scan.next_slot != written);
+            CHECK(out.pos_z == i);
+            consume_slot(written);
+        }
+    }
+
+    SECTION( "Consumed record is not recovered" ) {
+        uvlo_record_t rec = make_record(1.f);
+        uvlo_record_seal(rec, 3);
+        write_slot(0, rec);
+        consume_slot(0);
+        const uvlo_record_scan_t scan = uvlo_record_scan(base, image_rd, out);
+        CHECK(scan.valid_slot == -1);
+        CHECK(scan.next_slot == 1);
+        CHECK(scan.next_seq == 4);
+    }
+
+    SECTION( "Torn write does not fall back to an older record" ) {
+        uvlo_record_t old_rec = make_record(1.f);
+        uvlo_record_seal(old_rec, 3);
+        write_slot(0, old_rec);
+
+        // Power lost halfway through programming the newer record
+        uvlo_record_t rec = make_record(2.f);
+        uvlo_record_seal(rec, 4);
+        image_program(base + UVLO_RECORD_SLOT_SIZE, &rec, sizeof(rec) / 2);
+
+        const uvlo_record_scan_t scan = uvlo_record_scan(base, image_rd, out);
+        CHECK(scan.valid_slot == -1);
+        CHECK(scan.next_slot == 0);
+        CHECK(scan.next_seq == 5);
+    }
+
+    SECTION( "Sequence number wraps around" ) {
+        uvlo_record_t rec0 = make_record(1.f);
+        uvlo_record_seal(rec0, 0xFFFF);
+        write_slot(0, rec0);
+        uvlo_record_t rec1 = make_record(2.f);
+        uvlo_record_seal(rec1, 0);
+        write_slot(1, rec1);
+
+        const uvlo_record_scan_t scan = uvlo_record_scan(base, image_rd, out);
+        CHECK(scan.valid_slot == 1);
+        CHECK(out.pos_z == 2.f);
+        CHECK(scan.next_slot == 0);
+        CHECK(scan.next_seq == 1);
+    }
+}
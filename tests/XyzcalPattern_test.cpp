@@ -0,0 +1,241 @@
+/**
+ * @file
+ * @brief Calibration point pattern search on scanned 32x32 images, compared against the former pixel by pixel search.
+ */
+
+#include "catch2/catch_test_macros.hpp"
+#include "../Firmware/xyzcal_pattern.h"
+
+#include <math.h>
+#include <stdio.h>
+
+// Images in the print_image() format, one row of 32 hex pixels per line.
+// Further dumps from the M45 debug output can be pasted in the same way.
+// centered point, center [15.5 15.5]
+static const char* const image0[32] = {
+    "080a060907070b0807090a070906070705040407070708050708090607030603",
+    "050a0309080708090a0706060607060a040506030b0307060b040a0607060905",
+    "07080b030b090708070b0807070707060c04000707080707080907070b09060c",
+    "09060508060505060a07050908090a07070705090a0807070606070607040808",
+    "0503070a0607060906090709080705060709080608090707070909060807060a",
+    "0906080906070904080909050806090908060609060809070c080c0303090907",
+    "0704060507090808060708070a060b060a060b0808090605030a0606070b0408",
+    "07090407090b0b06080705050908070a05090807080808080b070a090709060a",
+    "0607080909090706090806090806080506080408050906080407090804090907",
+    "0a05070a0a0a0504080507050a0909080807080808070b080a0a06040a070807",
+    "080507070703090804060809080a0805060906090a090a070706060406050508",
+    "08070a090a0605090809080a07488eb2b693440a0607080806080809060b0b0c",
+    "05080408090504080906070269bcbcbfb9b7bc690809090a0a04070c07090707",
+    "0b0a07090506090805080849bdbbbbbbbbbebfbe480709070804070a0505070b",
+    "0a070707060807050607068dbdbfbbbbbdbbbabe8e06060607090a0908050706",
+    "0709080706070806060904b6b9bfbdbdbcbcbcb8b70905090904070706080507",
+    "0809080709040907050704b2bbbabdbab9babfbcb5060507080a0a0806060305",
+    "080708050908080803060693bbbabdb9bebabbba910309060805080809080909",
+    "07050509070a0805090b0745babdbabbbdbcbcba4608080907080808090a0808",
+    "0608070706090d080808060869babcbcbbbabc68090708090905070805030707",
+    "080808080a0809070a07090308478fb9b78f460b0909060a0907070409050907",
+    "060808050709070507060608070704080707080b050409060a06070909080807",
+    "07070a090808090a0707080d080a040905050607080808070d08090c0909080b",
+    "05060803060a0708090508060507070706090a09070506050809090707080809",
+    "0a060c03040505070c060a0708050c07060c0808070605070b08070a060a0706",
+    "09090708090a06020c070708070a0507050b070a0a0507090807090906070908",
+    "08050b070807080806080a080908080b06080a0805050b060809080404070607",
+    "080805040906050409050509080905020607060908050907070a040a0a030707",
+    "0506060806030a0906090c0407060907050a07090c0607090709070d09080808",
+    "040709050807060c090806080707080d0a0b0a0d060508080806090b08070a07",
+    "0708030b07090808050b09080e050907050b04080708060a0805050805080806",
+    "040508060b07080908080a0708070c080902070508070507090a060a0609060a",
+};
+
+// small point on a tilted bed, center [11.2 18.7]
+static const char* const image1[32] = {
+    "15060f000518080c000905110719040c0008120b040f110f1204181100180b11",
+    "0004000d07030710050d030007090b100809100e0b0d0009030a1203130a0c0b",
+    "0c04000a080d0d020b0a090b0c070a11050b0505090d150b12100d000e0e070f",
+    "1101050e00030b0f110e180d03090f0d000e070b150b080c09191213090a0f01",
+    "0e01090b040b0e150c150d0910080c0f120d03140d0b08100f110d170c100f15",
+    "0407080505020e13040f0406090c0e00040c0a190b091400021e0a0e0d090d07",
+    "0e0d0d040007030c01050b0d0c0407181107180c0c08160e0d08060f0e18090c",
+    "0f0e05120c0f0c100809110d0d120d0e000911070b0e0c12100d140c0a10120e",
+    "03060b0e1409090012100b070010071511140c1404160d060b08100a070c0d10",
+    "0d110c14000a10030a0c02080f0a151a0c060c0a050b0b0c1314110c110f1009",
+    "000f06070a0a09140c0d060b0e0b0e070f070a080e140f090f141312080c0b0d",
+    "0b0a080e06090b030603050b0b0e0e06181506090b0f120e002014140b10150d",
+    "110b140b1301140e09120a1112131a151c110e100d070f070d0d0c09100f1814",
+    "10070903060f0a0b08150c130c120705140b0f131210070a0f1312110b10160b",
+    "0710140d0b050b070d100f250c051513080e070e10140907120d18090c001718",
+    "0d090003081711080f69b3bbbe8e2e0b1c0f0b13130e19150f13130e140d0f14",
+    "0309050f081615087bbec1c5cacebc1f0b0d0c0f120c0b1d131c0c181a180c14",
+    "06040b0e0a0b1039c3c5c5c4bbc0bf85040f05120c0f15190a10040f0c141011",
+    "0409050c020e137ecac9c6cbc1c4b7b31504100e0d110f090f051910160b1c17",
+    "0d0d0e070b0b0f80c8c3c5c0bfb8bab90e0e1116130e0d0e140b070f17181506",
+    "0b101217070f0354bfc6c2b7c1c4cb97090b150d10120b16061b0c0b0c0a0c0d",
+    "050b0e090d080e0da1c2c1bec2c5bb4c120f141e08120e19140817110f11130c",
+    "0914060911070c0f2da2bcc1c4c26511140910190e0e100c1411101518090f10",
+    "0410191114010a05120d496a6031171405171007110f10160915180a1a0e0d18",
+    "0c0109110a0a0d0d0a0811160011150a1806151a1900110b1319141b080d0f16",
+    "140807120511090d1a0c0f0a1218130712190a0f0b0d0b091411040b0d0b1311",
+    "0f05080a0b0b090d180a05100914151a11061a1618110f1106170e0e140d170f",
+    "1b14110f0e0b020b0a0b0f04080b0d15200f1410121b1215120e18111b0c151d",
+    "090f1610090c100b0c1007190c0f10180e1d1c15090910131619151315061a0a",
+    "02090b060d0f12110c10170e0f03121c150f1818190a0b16151509171e1a2316",
+    "0e19140005100c1a19170d0e150e141215110c00090916090f151719161c101a",
+    "050b10120d0b070103190506060e0f0d091008131a0c130f100a13131b220d1a",
+};
+
+// noisy scan with saturated edges, center [20.4 9.6]
+static const char* const image2[32] = {
+    "ffff000d14070a000500080020150304050a0b1c05000c0e011208020900061c",
+    "ffff090b000a01021801090913060e0d0703001401151b04000005180200000c",
+    "ffff0b0808251812050708080e021c00101113170d0c19170a13000f00170414",
+    "ffff1119001c0d00060d1001060e0c1d12130101000a111b14020a200c100000",
+    "ffff0e0700210d001a12080a0f00140d1104041f0a35160008040500000c0911",
+    "ffff1e190007060d0019061f021d0e130d1c6ebbb7bcae6f0e0800140407100b",
+    "ffff001007110a05180b1310121410011cb0bdbbbfc8b6be860412050c0f1010",
+    "ffff0011190509120109050f0a1a010378c0bdbcc4b5b1d4bf5e150c020f1613",
+    "ffff00070e00100d130d1d0006050a2fb4c8c9c0b1c5c3b6b8ad000f160f050b",
+    "ffff050e0615010f0610000915110066c3bcbbb6cecccdb5adaa1b0600001105",
+    "ffff01041500040007030b0515020956b5b8bdbac6b7afc5b6b82916130d0e07",
+    "ffff0012000102191d0a0417041a003bb6cfbfb8bfa7bfc5d6b31c1812080d03",
+    "ffff040a0000080c100e1a0917001111abb8d1bebaaec8b9c77b130c05070c10",
+    "ffff0000100d1e1400000a091105030335b4bdc6bdb4c4c79b1600010000051f",
+    "ffff0d0a0a000800050800000e171300063c96a8c6b8be75141706101c0c0c09",
+    "ffff0d190e16010710010009050e1a060007042d5b532d08150a1d0b0b132100",
+    "ffff00051200051c1606100a04021703090500081e000a17100b110e0b030700",
+    "ffff030004000f001201100f1307000e0400000d110e1216080b09080a0d070d",
+    "ffff0f00011b0816000009070011100310110b05110606000c1806060009140a",
+    "ffff00030f0600090e15010d0f001209001d0f0d2315010b1d181b0b17050a12",
+    "ffff080c1e0f150004130006071600050b0c0017121811120809001000171106",
+    "ffff00020003070301000010061600051119141400101e000f22000e1f110e15",
+    "ffff081201080b00130604000901111b06040a081000110b060015170f13150e",
+    "ffff1200151a16020710020e0a1a06051116080000000c010c00091101180d04",
+    "ffff01040c0023131721120a0a1019021d0801190613001307180005020f0209",
+    "ffff0b0d001500021c0309120409080900160b110c0517041604050d24160e11",
+    "ffff00000a03081908040b171c120807000515110f010b051b0c0b0c0c0d070f",
+    "ffff0f11050a0002060016140d23000c0d061b1711020e0d110002170d0c0c00",
+    "ffff001018160502110d0018000f0f130c140f03061a00130600041100161909",
+    "ffff1300060e000e0a13000b0f0c01170b0d0c130d05150c0d0e010e10000a0c",
+    "ffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff",
+    "ffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff",
+};
+
+static const struct {
+    const char* const* image;
+    float x, y;
+} images[] = {
+    { image0, 15.5f, 15.5f },
+    { image1, 11.2f, 18.7f },
+    { image2, 20.4f, 9.6f },
+};
+
+static const uint16_t pattern_10[12] = {0x000, 0x0f0, 0x1f8, 0x3fc, 0x7fe, 0x7fe, 0x7fe, 0x7fe, 0x3fc, 0x1f8, 0x0f0, 0x000};
+static const uint16_t pattern_08[12] = {0x000, 0x000, 0x0f0, 0x1f8, 0x3fc, 0x3fc, 0x3fc, 0x3fc, 0x1f8, 0x0f0, 0x000, 0x000};
+
+static void parse_image(const char* const* image, uint8_t* pixels)
+{
+    for (uint8_t r = 0; r < 32; ++r) {
+        for (uint8_t c = 0; c < 32; ++c) {
+            unsigned v;
+            sscanf(image[r] + 2 * c, "%2x", &v);
+            pixels[r * 32 + c] = v;
+        }
+    }
+}
+
+// Former implementation, comparing the pixels one by one
+static uint8_t legacy_match(const uint16_t* pattern, const uint8_t* pixels, uint8_t c, uint8_t r)
+{
+    uint8_t thr = 16;
+    uint8_t match = 0;
+    for (uint8_t i = 0; i < 12; ++i) {
+        for (uint8_t j = 0; j < 12; ++j) {
+            if (((i == 0) || (i == 11)) && ((j < 2) || (j >= 10))) continue;
+            if (((j == 0) || (j == 11)) && ((i < 2) || (i >= 10))) continue;
+            const uint16_t idx = (c + j) + 32 * ((uint16_t)r + i);
+            const bool high_pix = pixels[idx] > thr;
+            const bool high_pat = pattern[i] & (1 << j);
+            if (high_pix == high_pat)
+                match++;
+        }
+    }
+    return match;
+}
+
+static uint8_t legacy_find(const uint8_t* pixels, const uint16_t* pattern, uint8_t* pc, uint8_t* pr)
+{
+    uint8_t max_c = 0, max_r = 0, max_match = 0;
+    for (uint8_t r = 0; r < (32 - 12); ++r) {
+        for (uint8_t c = 0; c < (32 - 12); ++c) {
+            const uint8_t match = legacy_match(pattern, pixels, c, r);
+            if (max_match < match) {
+                max_c = c;
+                max_r = r;
+                max_match = match;
+            }
+        }
+    }
+    *pc = max_c;
+    *pr = max_r;
+    return max_match;
+}
+
+TEST_CASE( "Thresholded rows", "[xyzcal]" )
+{
+    uint8_t pixels[32 * 32];
+    uint32_t rows[32];
+    for (const auto& img : images) {
+        parse_image(img.image, pixels);
+        xyzcal_threshold_32x32(pixels, rows);
+        for (uint8_t r = 0; r < 32; ++r)
+            for (uint8_t c = 0; c < 32; ++c)
+                CHECK(bool(rows[r] & (1ul << c)) == (pixels[r * 32 + c] > XYZCAL_PIXEL_THRESHOLD));
+    }
+}
+
+TEST_CASE( "Match rate equals the pixel by pixel comparison", "[xyzcal]" )
+{
+    uint8_t pixels[32 * 32];
+    uint32_t rows[32];
+    for (const auto& img : images) {
+        parse_image(img.image, pixels);
+        xyzcal_threshold_32x32(pixels, rows);
+        for (const uint16_t* pattern : { pattern_08, pattern_10 }) {
+            for (uint8_t r = 0; r < 32 - 12; ++r)
+                for (uint8_t c = 0; c < 32 - 12; ++c)
+                    REQUIRE(xyzcal_match_pattern_12x12_in_32x32(pattern, rows, c, r) == legacy_match(pattern, pixels, c, r));
+        }
+    }
+
+    // An empty image matches everywhere outside the pattern
+    for (uint8_t r = 0; r < 32; ++r)
+        rows[r] = 0;
+    CHECK(xyzcal_match_pattern_12x12_in_32x32(pattern_10, rows, 0, 0) == 132 - 76);
+}
+
+TEST_CASE( "Pattern search", "[xyzcal]" )
+{
+    uint8_t pixels[32 * 32];
+    uint32_t rows[32];
+    for (const auto& img : images) {
+        parse_image(img.image, pixels);
+        xyzcal_threshold_32x32(pixels, rows);
+        uint8_t best_match = 0, best_c = 0, best_r = 0;
+        for (const uint16_t* pattern : { pattern_08, pattern_10 }) {
+            uint8_t c, r, lc, lr;
+            const uint8_t match = xyzcal_find_pattern_12x12_in_32x32(rows, pattern, &c, &r);
+            const uint8_t legacy = legacy_find(pixels, pattern, &lc, &lr);
+            CHECK(match == legacy);
+            CHECK(c == lc);
+            CHECK(r == lr);
+            if (match > best_match) {
+                best_match = match;
+                best_c = c;
+                best_r = r;
+            }
+        }
+        // the better pattern is centered within a pixel of the point, as used by find_patterns()
+        CHECK(best_match >= 88);
+        CHECK(fabsf(best_c + 5.5f - img.x) <= 1.f);
+        CHECK(fabsf(best_r + 5.5f - img.y) <= 1.f);
+    }
+}
@@ -0,0 +1,12 @@
+/**
+ * @file
+ * @brief Mock file to allow test compilation.
+ */
+
+#ifndef TESTS_AVR_INTERRUPT_H_
+#define TESTS_AVR_INTERRUPT_H_
+
+#define cli()
+#define sei()
+
+#endif /* TESTS_AVR_INTERRUPT_H_ */
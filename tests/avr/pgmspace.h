@@ -0,0 +1,18 @@
+/**
+ * @file
+ * @brief Mock file to allow test compilation.
+ */
+
+#ifndef TESTS_AVR_PGMSPACE_H_
+#define TESTS_AVR_PGMSPACE_H_
+
+#include <stdint.h>
+
+#define PROGMEM
+#define PSTR(s) (s)
+#define pgm_read_byte(addr) (*(const uint8_t *)(addr))
+#define pgm_read_word(addr) (*(const uint16_t *)(addr))
+#define pgm_read_byte_near(addr) pgm_read_byte(addr)
+#define pgm_read_word_near(addr) pgm_read_word(addr)
+
+#endif /* TESTS_AVR_PGMSPACE_H_ */
@@ -2,6 +2,8 @@ import sys
 import re
 import enum
 import struct
+import base64
+import binascii
 from . import avr
 
 
@@ -9,6 +11,11 @@ FILL_BYTE   = b'\0'      # used to fill memory gaps in the dump
 DUMP_MAGIC  = 0x55525547 # XFLASH dump magic
 DUMP_OFFSET = 0x3d000    # XFLASH dump offset
 DUMP_SIZE   = 0x2300     # XFLASH dump size
+DUMP_HEADER = '<LBBLHBH' # XFLASH dump header (dump_header_t)
+DUMP_FRAME_SIZE = 48     # bytes per packed line (DCODE_FRAME_SIZE)
+
+DUMP_COMPRESSION_NONE = 0xff
+DUMP_COMPRESSION_RLE  = 0x01
 
 class CrashReason(enum.IntEnum):
     MANUAL = 0
@@ -57,6 +64,48 @@ def merge_ranges(ranges):
     return ret
 
 
+# decode the run-length encoding of xfdump_rle()
+def rle_decode(data):
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        c = data[i]
+        i += 1
+        if c < 0x80:
+            out += data[i:i + c + 1]
+            i += c + 1
+        else:
+            out += data[i:i + 1] * (c - 0x80 + 3)
+            i += 1
+    return bytes(out)
+
+
+def crc16_ccitt(data, crc=0xffff):
+    # same as _crc_ccitt_update() from avr-libc
+    for b in data:
+        crc ^= b
+        for _ in range(8):
+            crc = (crc >> 1) ^ 0x8408 if crc & 1 else crc >> 1
+    return crc
+
+
+# decode a packed "#<addr> <base64> <crc16>" line, data is None if the line is corrupted
+def decode_framed(tokens):
+    values = tokens[1].split(' ')
+    if not re.match(r'^#[0-9a-fA-F]+$', tokens[0]):
+        return None
+    addr = int(tokens[0][1:], 16)
+    if len(values) != 2 or not re.match(r'^[0-9a-fA-F]{4}$', values[1]):
+        return addr, None
+    try:
+        data = base64.b64decode(values[0], validate=True)
+    except binascii.Error:
+        return addr, None
+    if crc16_ccitt(data) != int(values[1], 16):
+        return addr, None
+    return addr, data
+
+
 def decode_dump(path):
     fd = open(path, 'r')
     if fd is None:
@@ -101,13 +150,29 @@ def decode_dump(path):
                 else:
                     line_error()
                 continue
+            elif len(tokens) == 2 and tokens[0].startswith('#'):
+                frame = decode_framed(tokens)
+                if frame is None:
+                    line_error()
+                    continue
+                if frame[1] is None:
+                    # the firmware sends full lines, the next one starts where this one ends
+                    addr = frame[0]
+                    print('bad CRC on line {}: missing 0x{:x}-0x{:x}'.format(
+                        line[0], addr, addr + DUMP_FRAME_SIZE - 1), file=sys.stderr)
+                    continue
             elif len(tokens) != 2 or not re.match(r'^[0-9a-fA-F]+$', tokens[0]):
                 line_error()
                 continue
+            else:
+                frame = None
 
-        # decode hex data
-        addr = int.from_bytes(bytes.fromhex(tokens[0]), 'big')
-        data = bytes.fromhex(tokens[1])
+        if frame is not None:
+            addr, data = frame
+        else:
+            # decode hex data
+            addr = int.from_bytes(bytes.fromhex(tokens[0]), 'big')
+            data = bytes.fromhex(tokens[1])
         ranges.append((addr, len(data)))
 
         if buf_addr is None:
@@ -125,6 +190,8 @@ def decode_dump(path):
 
     # merge continuous ranges
     ranges = merge_ranges(ranges)
+    for prev, cur in zip(ranges, ranges[1:]):
+        print('warning: missing 0x{:x}-0x{:x}'.format(prev[0] + prev[1], cur[0] - 1), file=sys.stderr)
 
     if typ == 'D2':
         # D2 doesn't guarantee registers to be present
@@ -148,12 +215,13 @@ def decode_dump(path):
             print('warning: no error line in D23', file=sys.stderr)
 
     elif typ == 'D21':
-        if len(ranges) != 1 or len(buf_data) != (avr.SRAM_START + avr.SRAM_SIZE + 256):
+        if len(ranges) != 1 or len(buf_data) < 256:
             print('error: incomplete D21 dump', file=sys.stderr)
             return None
 
         # decode the header structure
-        magic, regs_present, crash_reason, pc, sp = struct.unpack('<LBBLH', buf_data[0:12])
+        magic, regs_present, crash_reason, pc, sp, compression, data_size = \
+            struct.unpack(DUMP_HEADER, buf_data[0:struct.calcsize(DUMP_HEADER)])
         if magic != DUMP_MAGIC:
             print('error: invalid dump header in D21', file=sys.stderr)
             return None
@@ -163,7 +231,13 @@ def decode_dump(path):
 
         # extract the data section
         buf_addr = 0
-        buf_data = buf_data[256:]
+        if compression == DUMP_COMPRESSION_RLE:
+            buf_data = rle_decode(buf_data[256:256 + data_size])
+        else:
+            buf_data = buf_data[256:]
+        if len(buf_data) != avr.SRAM_START + avr.SRAM_SIZE:
+            print('error: incomplete D21 dump', file=sys.stderr)
+            return None
         ranges[0] = (0, len(buf_data))
 
     return Dump(typ, reason, regs, pc, sp, buf_data, ranges)